@@ -1,30 +1,51 @@
 #include "Entity.h"
 
 Entity::Entity() : Object(ObjectType::ENTITY) {
-    _velocityX = 0;
-    _velocityY = 0;
-    _accelerationX = 0;
-    _accelerationY = 0;
-    _mass = 1;
-    loopTimer = timer::createTimer();
+    bodyIndex = physics::addBody(this);
 
     effectByCamera(true); // all entities are affected by camera
 }
 
+Entity::~Entity() {
+    physics::removeBody(bodyIndex);
+}
+
 double Entity::getFrameTime() {
-    auto elapsedTime = timer::getTimeDiff(loopTimer);
-    timer::resetTimer(loopTimer);
-    return elapsedTime;
+    return engine::getFrameDelta();
+}
+
+void Entity::setVelocityX(float velocityX) { physics::getBodies().velocityX[bodyIndex] = velocityX; wake(); }
+void Entity::setVelocityY(float velocityY) { physics::getBodies().velocityY[bodyIndex] = velocityY; wake(); }
+void Entity::setAccelerationX(float accelerationX) { physics::getBodies().accelerationX[bodyIndex] = accelerationX; wake(); }
+void Entity::setAccelerationY(float accelerationY) { physics::getBodies().accelerationY[bodyIndex] = accelerationY; wake(); }
+void Entity::setMass(float mass) { physics::getBodies().mass[bodyIndex] = mass; }
+
+float Entity::getVelocityX() { return physics::getBodies().velocityX[bodyIndex]; }
+float Entity::getVelocityY() { return physics::getBodies().velocityY[bodyIndex]; }
+float Entity::getAccelerationX() { return physics::getBodies().accelerationX[bodyIndex]; }
+float Entity::getAccelerationY() { return physics::getBodies().accelerationY[bodyIndex]; }
+float Entity::getMass() { return physics::getBodies().mass[bodyIndex]; }
+
+void Entity::setPhysicsEnabled(bool enabled) { physics::getBodies().enabled[bodyIndex] = enabled ? 1.0f : 0.0f; }
+bool Entity::isPhysicsEnabled() { return physics::getBodies().enabled[bodyIndex] != 0.0f; }
+
+void Entity::setGravityScale(float gravityScale) { physics::getBodies().gravityScale[bodyIndex] = gravityScale; }
+float Entity::getGravityScale() { return physics::getBodies().gravityScale[bodyIndex]; }
+
+void Entity::setContinuousCollision(bool continuous) { physics::getBodies().continuous[bodyIndex] = continuous ? 1 : 0; }
+bool Entity::isContinuousCollision() { return physics::getBodies().continuous[bodyIndex] != 0; }
+
+void Entity::setRestitution(float restitution) { physics::getBodies().restitution[bodyIndex] = restitution; }
+float Entity::getRestitution() { return physics::getBodies().restitution[bodyIndex]; }
+
+void Entity::setFriction(float friction) { physics::getBodies().friction[bodyIndex] = friction; }
+float Entity::getFriction() { return physics::getBodies().friction[bodyIndex]; }
+
+void Entity::wake() {
+    physics::getBodies().awake[bodyIndex] = 1.0f;
+    physics::getBodies().sleepTime[bodyIndex] = 0.0f;
 }
 
-void Entity::setVelocityX(float velocityX) { _velocityX = velocityX; }
-void Entity::setVelocityY(float velocityY) { _velocityY = velocityY; }
-void Entity::setAccelerationX(float accelerationX) { _accelerationX = accelerationX; }
-void Entity::setAccelerationY(float accelerationY) { _accelerationY = accelerationY; }
-void Entity::setMass(float mass) { _mass = mass; }
-
-float Entity::getVelocityX() { return _velocityX; }
-float Entity::getVelocityY() { return _velocityY; }
-float Entity::getAccelerationX() { return _accelerationX; }
-float Entity::getAccelerationY() { return _accelerationY; }
-float Entity::getMass() { return _mass; }
+bool Entity::isSleeping() { return physics::getBodies().awake[bodyIndex] == 0.0f; }
+
+unsigned int Entity::getBodyIndex() const { return bodyIndex; }
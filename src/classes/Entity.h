@@ -11,12 +11,43 @@
 class Entity : public Object {
 public:
     Entity();
+    ~Entity();
 
     virtual void update(double elapsedTime) = 0; // override this function to update object
     virtual void events() = 0; // override this function to handle events
 
     /**
-     * @brief Returns the elapsed time since the last execution of this object in the last frame.
+     * @brief Called by the engine once per fixed tick while physics is in deterministic mode.
+     * Put gameplay that has to give the same result on every machine here instead of in update.
+     * 
+     * @param tickMilliseconds The length of a tick, the same every call.
+     */
+    virtual void fixedUpdate(double tickMilliseconds) {}
+
+    /**
+     * @brief Called by the engine when the entity or one of its hitboxes starts touching another object.
+     * Called once per object, even if more hitboxes touch it later.
+     * The normal of the contact points away from this entity.
+     * 
+     * @param otherID The other object, or the parent of the other hitbox.
+     * @param contact The contact, idA is the part of this entity that was hit.
+     */
+    virtual void onCollisionEnter(unsigned int otherID, const ContactManifold& contact) {}
+
+    /**
+     * @brief Called by the engine every frame while the entity keeps touching another object after the first frame.
+     * Called once per frame with one of the contacts, however many hitboxes touch the object.
+     */
+    virtual void onCollisionStay(unsigned int otherID, const ContactManifold& contact) {}
+
+    /**
+     * @brief Called by the engine on the first frame neither the entity nor any of its hitboxes touches the other object anymore.
+     * Also called when the other object is deleted.
+     */
+    virtual void onCollisionExit(unsigned int otherID) {}
+
+    /**
+     * @brief Returns the elapsed time since the last frame, the same engine frame delta for every object.
      * It is used for calculating elapsed time for "update" function.
      * WARNING: This function is called automatically per frame by the engine.
      * 
@@ -36,10 +67,54 @@ public:
     float getAccelerationY();
     float getMass();
 
-private:
-    float _velocityX, _velocityY; // m/s
-    float _accelerationX, _accelerationY; // m/s^2
-    float _mass; // kg
+    /**
+     * @brief Sets if the entity is moved by the physics step every frame. Disabled by default.
+     * 
+     * @param enabled Whether the engine integrates the velocity and acceleration of the entity.
+     */
+    void setPhysicsEnabled(bool enabled);
+    bool isPhysicsEnabled();
+
+    /**
+     * @brief Sets how strongly the gravity pulls the entity, 0 by default.
+     */
+    void setGravityScale(float gravityScale);
+    float getGravityScale();
+
+    /**
+     * @brief Sets if the physics step sweeps the entity along its movement and stops it at the first contact.
+     * Use it for fast objects like bullets that would pass through thin walls otherwise. Disabled by default.
+     * It has no effect in the deterministic mode of the physics.
+     * 
+     * @param continuous Whether continuous collision is enabled.
+     */
+    void setContinuousCollision(bool continuous);
+    bool isContinuousCollision();
 
-    unsigned int loopTimer;
+    /**
+     * @brief Sets how bouncy the entity is in collisions, from 0 to 1. 0 by default.
+     */
+    void setRestitution(float restitution);
+    float getRestitution();
+
+    /**
+     * @brief Sets how much the entity resists sliding on other objects. 0.5 by default.
+     */
+    void setFriction(float friction);
+    float getFriction();
+
+    /**
+     * @brief Wakes the entity and everything resting on it. Changing the velocity or acceleration wakes it too,
+     * moving it with setX or setY wakes it at the next physics step.
+     */
+    void wake();
+    bool isSleeping();
+
+    /**
+     * @brief Gets the index of the entity in the physics body arrays.
+     */
+    unsigned int getBodyIndex() const;
+
+private:
+    unsigned int bodyIndex; // velocity, acceleration and mass live in the physics body arrays
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "../sys/Engine.h"
 #include "../sys/Events.h"
+#include "../sys/Collision.h"
+#include "../sys/Logger.h"
 
 #include "../core/Application.h"
 
@@ -13,35 +15,30 @@ Hitbox::Hitbox(unsigned int parentID, float relativeX, float relativeY, float wi
 
     showKeyCode = GLFW_KEY_F3;
 
-    setBuffers(engine::getBuffers(EMPTY_RECTANGULAR_BUFFERS));
-
     closeAnimation();
-
-    createVertexData();
-    createIndexData();
 }
 
-void Hitbox::draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) {
-    if (!App::isShowingStats()) return;
-
-    if (buffers.has_value() && shaders.has_value()) {
-        shaders.value()->activate();
-        glm::mat4 model = getModelMatrix(window->getWidth(), window->getHeight());
-        glm::mat4 view = window->getProjectionMatrix();
-        shaders.value()->setUniform("u_Model", (float*)&model, SHADER_MAT4);
-        shaders.value()->setUniform("u_View", (float*)&view, SHADER_MAT4);
-
-        if (isAffectedByCamera() && camera != nullptr) {
-            glm::mat4 view = camera->getViewMatrix();
-            glm::mat4 projection = camera->getProjectionMatrix();
-            shaders.value()->setUniform("u_View", (float*)&view, SHADER_MAT4);
-            shaders.value()->setUniform("u_Projection", (float*)&projection, SHADER_MAT4);
-        }
-
-        buffers.value()->bind();
-        buffers.value()->setVertexData(vertices, indices);
-        buffers.value()->drawElements(GL_LINES);
-        buffers.value()->unbind();
+void Hitbox::record(CommandBuffer& commands, const RenderContext& context) {
+    if (!context.showHitboxes) return;
+
+    RenderCommand& command = commands.push(CommandType::OUTLINE);
+    command.affectedByCamera = isAffectedByCamera();
+
+    Transform2D world = getTransform();
+
+    // unit quad corners, in the same order as the outline is drawn
+    float corners[4][2] = {
+        {-0.5f, -0.5f},
+        { 0.5f, -0.5f},
+        { 0.5f,  0.5f},
+        {-0.5f,  0.5f}
+    };
+
+    for (int i = 0; i < 4; i++) {
+        float cornerX = world.applyX(corners[i][0], corners[i][1]);
+        float cornerY = world.applyY(corners[i][0], corners[i][1]);
+
+        command.vertices[i] = {glm::vec3(cornerX, cornerY, 0.0f), getColor(0), glm::vec2(0.0f, 0.0f)};
     }
 }
 
@@ -54,27 +51,15 @@ void Hitbox::syncAngleWithParent() {
     setRotation(engine::getObject(_parentID)->getAngle());
 }
 
-void Hitbox::createVertexData() {
-    if (vertices.size() > 0) vertices.clear();
+unsigned int Hitbox::getParentID() const { return _parentID; }
 
-    vertices.push_back({glm::vec3(-WINDOW_WIDTH/4.0f, -WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(1.0f, 1.0f)});
-    vertices.push_back({glm::vec3(WINDOW_WIDTH/4.0f, -WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(0.0f, 1.0f)});
-    vertices.push_back({glm::vec3(WINDOW_WIDTH/4.0f, WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(0.0f, 0.0f)});
-    vertices.push_back({glm::vec3(-WINDOW_WIDTH/4.0f, WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(1.0f, 0.0f)});
-}
-
-void Hitbox::createIndexData() {
-    if (indices.size() > 0) indices.clear();
-
-    indices.push_back(0);
-    indices.push_back(2);
-
-    indices.push_back(2);
-    indices.push_back(1);
-
-    indices.push_back(1);
-    indices.push_back(3);
+void Hitbox::setPolygon(const std::vector<glm::vec2>& points) {
+    if (!points.empty() && (points.size() < 3 || points.size() > MAX_POLYGON_VERTICES)) {
+        logError("A hitbox polygon needs 3 to " + std::to_string(MAX_POLYGON_VERTICES) + " points.", INVALID_POLYGON);
+        return;
+    }
 
-    indices.push_back(3);
-    indices.push_back(0);
+    polygon = points;
 }
+
+const std::vector<glm::vec2>& Hitbox::getPolygon() const { return polygon; }
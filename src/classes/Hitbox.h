@@ -11,17 +11,32 @@ class Hitbox : public Object {
     public:
         Hitbox(unsigned int parentID, float relativeX, float relativeY, float width, float height, float angle = 0);
 
-        void draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) override;
+        void record(CommandBuffer& commands, const RenderContext& context) override;
 
+        /**
+         * @brief Moves the hitbox to its parent. Registered hitboxes are attached to their parent by the engine
+         * and follow it every frame, so this is only needed before registration.
+         */
         void syncCoordsWithParent();
         void syncAngleWithParent();
 
-    private:
-        void createVertexData() override;
-        void createIndexData() override;
+        unsigned int getParentID() const;
+
+        /**
+         * @brief Gives the hitbox a convex polygon instead of its rectangle.
+         * The polygon turns with the hitbox around its center.
+         * 
+         * @param points Up to MAX_POLYGON_VERTICES points relative to the top left corner of the hitbox, in order around the shape.
+         * An empty list goes back to the rectangle.
+         */
+        void setPolygon(const std::vector<glm::vec2>& points);
+        const std::vector<glm::vec2>& getPolygon() const;
 
+    private:
         unsigned int _parentID;
 
+        std::vector<glm::vec2> polygon;
+
         float _relativeX, _relativeY;
 
         int showKeyCode;
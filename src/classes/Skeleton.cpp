@@ -0,0 +1,190 @@
+#include "Skeleton.h"
+
+#include "../sys/Jobs.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    std::vector<Skeleton*> skeletons; // every living skeleton, sampled together
+
+    BoneKey sampleTrack(const std::vector<BoneKey>& track, float time) {
+        if (time <= track.front().time) return track.front();
+        if (time >= track.back().time) return track.back();
+
+        auto next = std::upper_bound(track.begin(), track.end(), time, [](float t, const BoneKey& key) { return t < key.time; });
+        auto previous = next - 1;
+
+        float f = (time - previous->time) / (next->time - previous->time);
+
+        return {
+            time,
+            previous->x + (next->x - previous->x) * f,
+            previous->y + (next->y - previous->y) * f,
+            previous->angle + (next->angle - previous->angle) * f,
+            previous->scaleX + (next->scaleX - previous->scaleX) * f,
+            previous->scaleY + (next->scaleY - previous->scaleY) * f
+        };
+    }
+}
+
+Skeleton::Skeleton(float x, float y, float width, float height) : Object(ObjectType::OBJECT, x, y, width, height, 0) {
+    currentClip = -1;
+    clipTime = 0;
+    speed = 1;
+
+    effectByCamera(true); // characters live in the world like entities
+
+    registryIndex = skeletons.size();
+    skeletons.push_back(this);
+}
+
+Skeleton::~Skeleton() {
+    for (auto& sprite : sprites) textures::release(sprite.frame.texture);
+
+    // swap with the last skeleton so the list stays packed
+    Skeleton* last = skeletons.back();
+    skeletons[registryIndex] = last;
+    last->registryIndex = registryIndex;
+    skeletons.pop_back();
+}
+
+void Skeleton::record(CommandBuffer& commands, const RenderContext& context) {
+    if (!isVisible() || spriteVertices.empty()) return;
+    if (!isInView(context)) return;
+
+    for (unsigned int i = 0; i < sprites.size(); i++) {
+        RenderCommand& command = commands.push(CommandType::QUAD);
+        command.affectedByCamera = isAffectedByCamera();
+        command.texture = sprites[i].frame.texture;
+
+        std::copy(spriteVertices.begin() + i * 4, spriteVertices.begin() + i * 4 + 4, command.vertices);
+    }
+}
+
+int Skeleton::addBone(const std::string& name, int parent, float x, float y, float angle, float scaleX, float scaleY) {
+    if (parent >= (int)bones.size()) return -1;
+
+    bones.push_back({name, parent, x, y, angle, scaleX, scaleY});
+    worldTransforms.push_back(Transform2D::fromTRS(x, y, angle, scaleX, scaleY));
+
+    for (auto& clip : clips) clip.tracks.emplace_back();
+
+    return bones.size() - 1;
+}
+
+int Skeleton::findBone(const std::string& name) const {
+    for (unsigned int i = 0; i < bones.size(); i++)
+        if (bones[i].name == name) return i;
+
+    return -1;
+}
+
+void Skeleton::attachSprite(int bone, const std::string& spriteName, float x, float y, float width, float height, float angle, int drawOrder) {
+    if (bone < 0 || bone >= (int)bones.size()) return;
+
+    // atlas sprites of one character end up on the same page and in the same batch
+    BoneSprite sprite = {bone, textures::acquireFrame(spriteName), x, y, width, height, angle, drawOrder};
+
+    auto position = std::upper_bound(sprites.begin(), sprites.end(), drawOrder, [](int order, const BoneSprite& other) {
+        return order < other.drawOrder;
+    });
+
+    sprites.insert(position, sprite);
+    spriteVertices.clear();
+}
+
+int Skeleton::addClip(const std::string& name, float duration, bool looping) {
+    clips.push_back({name, duration, looping, std::vector<std::vector<BoneKey>>(bones.size())});
+
+    return clips.size() - 1;
+}
+
+void Skeleton::addKey(int clip, int bone, const BoneKey& key) {
+    if (clip < 0 || clip >= (int)clips.size() || bone < 0 || bone >= (int)bones.size()) return;
+
+    auto& track = clips[clip].tracks[bone];
+
+    auto position = std::upper_bound(track.begin(), track.end(), key.time, [](float time, const BoneKey& other) {
+        return time < other.time;
+    });
+
+    track.insert(position, key);
+}
+
+void Skeleton::play(const std::string& name) {
+    for (unsigned int i = 0; i < clips.size(); i++) {
+        if (clips[i].name != name) continue;
+
+        currentClip = i;
+        clipTime = 0;
+        return;
+    }
+}
+
+void Skeleton::setSpeed(float speed) { this->speed = speed; }
+
+Transform2D Skeleton::getBoneTransform(int bone) const {
+    return worldTransforms.at(bone);
+}
+
+void Skeleton::animate(float milliseconds, bool visible) {
+    const Clip* clip = currentClip >= 0 ? &clips[currentClip] : nullptr;
+
+    if (clip != nullptr && clip->duration > 0) {
+        clipTime += milliseconds * speed;
+        clipTime = clip->looping ? std::fmod(clipTime, clip->duration) : std::min(clipTime, clip->duration);
+    }
+
+    if (!visible) return;
+
+    Transform2D root = Transform2D::fromTRS(x + width / 2.0f, y + height / 2.0f, angle, 1.0f, 1.0f);
+
+    // parents come before children, so one pass in order is enough
+    for (unsigned int i = 0; i < bones.size(); i++) {
+        const Bone& bone = bones[i];
+        BoneKey local = {clipTime, bone.x, bone.y, bone.angle, bone.scaleX, bone.scaleY};
+
+        if (clip != nullptr && !clip->tracks[i].empty()) local = sampleTrack(clip->tracks[i], clipTime);
+
+        Transform2D localTransform = Transform2D::fromTRS(local.x, local.y, local.angle, local.scaleX, local.scaleY);
+        worldTransforms[i] = (bone.parent < 0 ? root : worldTransforms[bone.parent]) * localTransform;
+    }
+
+    // unit quad corners and texture coordinates, copied from Object::createVertexData so bone sprites
+    // come out the same way up as objects (frames are flipped, v1 is the top of the image)
+    const float corners[4][2] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+    const float texCoords[4][2] = {{1.0f, 1.0f}, {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}};
+
+    glm::vec4 tint = vertices[0].color;
+
+    spriteVertices.resize(sprites.size() * 4);
+
+    for (unsigned int i = 0; i < sprites.size(); i++) {
+        const BoneSprite& sprite = sprites[i];
+        const SpriteFrame& frame = sprite.frame;
+
+        Transform2D quad = worldTransforms[sprite.bone] * Transform2D::fromTRS(sprite.x, sprite.y, sprite.angle, sprite.width, sprite.height);
+
+        for (int corner = 0; corner < 4; corner++) {
+            float u = frame.u0 + texCoords[corner][0] * (frame.u1 - frame.u0);
+            float v = frame.v0 + texCoords[corner][1] * (frame.v1 - frame.v0);
+
+            spriteVertices[i * 4 + corner] = {
+                glm::vec3(quad.applyX(corners[corner][0], corners[corner][1]), quad.applyY(corners[corner][0], corners[corner][1]), 1.0f),
+                tint,
+                glm::vec2(u, v)
+            };
+        }
+    }
+}
+
+void Skeleton::updateAll(double milliseconds, const RenderContext& context) {
+    // every skeleton only writes its own pose, so they can be sampled on any worker
+    jobs::parallelFor(skeletons.size(), 4, [&](unsigned int begin, unsigned int end, unsigned int worker) {
+        for (unsigned int i = begin; i < end; i++) {
+            Skeleton* skeleton = skeletons[i];
+            skeleton->animate((float)milliseconds, skeleton->isVisible() && skeleton->isInView(context));
+        }
+    });
+}
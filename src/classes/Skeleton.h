@@ -0,0 +1,151 @@
+#pragma once
+
+#include "../util/Object.h"
+#include "../sys/Textures.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Local transform of a bone at a point of a clip. Values replace the bind pose, they are not added to it.
+ */
+struct BoneKey {
+    float time; /**< milliseconds from the start of the clip. */
+    float x, y;
+    float angle; /**< degrees, same direction as Object angles. */
+    float scaleX, scaleY;
+};
+
+/**
+ * @brief This class represents a character made of sprites attached to a bone hierarchy.
+ * Bones are animated with keyframed clips instead of baked frames, so only the parts of the character
+ * are kept in texture memory. All skeletons are sampled in parallel once per frame and
+ * their sprites are recorded as batched quads.
+ */
+class Skeleton : public Object {
+public:
+    /**
+     * @param x The x-coordinate of the bounds. The root bone is at the center of the bounds.
+     * @param y The y-coordinate of the bounds.
+     * @param width The width of the bounds, only used to cull the skeleton.
+     * @param height The height of the bounds, only used to cull the skeleton.
+     */
+    Skeleton(float x = 0, float y = 0, float width = 0, float height = 0);
+    ~Skeleton();
+
+    void record(CommandBuffer& commands, const RenderContext& context) override;
+
+    /**
+     * @brief Adds a bone. Parents must be added before their children.
+     *
+     * @param name The name of the bone.
+     * @param parent The index of the parent bone, -1 for a root bone.
+     * @param x The bind position relative to the parent.
+     * @param y The bind position relative to the parent.
+     * @param angle The bind rotation in degrees.
+     * @return The index of the bone, or -1 if the parent doesn't exist yet.
+     */
+    int addBone(const std::string& name, int parent, float x, float y, float angle = 0, float scaleX = 1, float scaleY = 1);
+
+    /**
+     * @brief Gets the index of a bone by name.
+     *
+     * @return The index, or -1 if there is no such bone.
+     */
+    int findBone(const std::string& name) const;
+
+    /**
+     * @brief Attaches a sprite to a bone. Sprites are drawn in attach order, lower draw orders first.
+     *
+     * @param bone The index of the bone.
+     * @param spriteName The name of a saved sprite.
+     * @param x The center of the sprite relative to the bone.
+     * @param y The center of the sprite relative to the bone.
+     * @param width The width of the sprite.
+     * @param height The height of the sprite.
+     * @param angle The rotation of the sprite relative to the bone in degrees.
+     * @param drawOrder Sprites with a higher order are drawn on top.
+     */
+    void attachSprite(int bone, const std::string& spriteName, float x, float y, float width, float height, float angle = 0, int drawOrder = 0);
+
+    /**
+     * @brief Creates an empty clip.
+     *
+     * @param name The name of the clip.
+     * @param duration The length of the clip in milliseconds.
+     * @param looping Whether the clip starts over when it ends.
+     * @return The index of the clip.
+     */
+    int addClip(const std::string& name, float duration, bool looping = true);
+
+    /**
+     * @brief Adds a keyframe to the track of a bone. Keys can be added in any order.
+     */
+    void addKey(int clip, int bone, const BoneKey& key);
+
+    /**
+     * @brief Starts playing a clip from the beginning.
+     *
+     * @param name The name of the clip.
+     */
+    void play(const std::string& name);
+
+    void setSpeed(float speed);
+
+    /**
+     * @brief Gets the world transform of a bone, as of the last sample.
+     */
+    Transform2D getBoneTransform(int bone) const;
+
+    /**
+     * @brief Advances and samples all skeletons on all workers, then computes the quads of their sprites.
+     * Skeletons that are hidden or out of view only advance their time.
+     * WARNING: This function is called automatically per frame by the engine.
+     *
+     * @param milliseconds The time since the last frame.
+     * @param context The frame information.
+     */
+    static void updateAll(double milliseconds, const RenderContext& context);
+
+private:
+    struct Bone {
+        std::string name;
+        int parent;
+
+        float x, y, angle, scaleX, scaleY; // bind pose
+    };
+
+    struct BoneSprite {
+        int bone;
+        SpriteFrame frame;
+
+        float x, y, width, height, angle;
+        int drawOrder;
+    };
+
+    struct Clip {
+        std::string name;
+        float duration;
+        bool looping;
+
+        std::vector<std::vector<BoneKey>> tracks; // one per bone, sorted by time
+    };
+
+    /**
+     * @brief Samples the current clip, then builds world transforms and sprite quads in bone order.
+     */
+    void animate(float milliseconds, bool visible);
+
+    std::vector<Bone> bones;
+    std::vector<BoneSprite> sprites;
+    std::vector<Clip> clips;
+
+    std::vector<Transform2D> worldTransforms; // one per bone
+    std::vector<Vertex> spriteVertices; // 4 per sprite, ready to record
+
+    int currentClip;
+    float clipTime;
+    float speed;
+
+    unsigned int registryIndex; // position in the list of skeletons updated every frame
+};
@@ -15,14 +15,11 @@ public:
     virtual void events() = 0; // override this function to handle events
 
     /**
-     * @brief Returns the elapsed time since the last execution of this object in the last frame.
+     * @brief Returns the elapsed time since the last frame, the same engine frame delta for every object.
      * It is used for calculating elapsed time for "update" function.
      * WARNING: This function is called automatically per frame by the engine.
      * 
      * @return double elapsed time in milliseconds
      */
     double getFrameTime();
-
-private:
-    unsigned int loopTimer;
 };
@@ -6,24 +6,42 @@
 #include "../sys/Events.h"
 #include "../sys/Events.h"
 #include "../sys/TextRendering.h"
+#include "../sys/Capture.h"
+#include "../sys/DebugDraw.h"
+#include "../sys/Renderer.h"
+#include "../sys/Jobs.h"
+#include "../sys/Textures.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <string>
 
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
 #include <windows.h>
 #endif
 
 // Static variables
 
 int App::sessionTimer;
-int App::frameTimer;
+double App::frameDeadline;
 double App::checkPoint;
 int App::currentFPS;
 int App::lastFPS ;
 const char* App::_name;
 const char* App::_version;
 bool App::_debugMode;
+bool App::_headless;
+int App::_frameLimit;
+std::string App::_recordPath;
+std::string App::_statsPath;
+bool App::_noAtlas;
+unsigned long long App::frameCount;
 bool App::isInitSuccess;
 bool App::showStats;
 std::shared_ptr<Window> App::focusedWindow;
@@ -31,9 +49,9 @@ GLenum App::currentError;
 
 namespace {
     /**
-     * @brief Parse args (--help, --version, --debug)
+     * @brief Parse args (--help, --version, --debug, --headless, --frames, --record, --stats, --no-atlas)
      */
-    bool parseArgs(char* args[], bool& debugMode, const char* name, const char* version) {
+    bool parseArgs(char* args[], bool& debugMode, bool& headless, int& frameLimit, std::string& recordPath, std::string& statsPath, bool& noAtlas, const char* name, const char* version) {
         for(const char *const *it = args + 1; *it; ++it) {
             std::string arg = *it;
             if(arg == "-h" || arg == "--help") {
@@ -50,6 +68,26 @@ namespace {
                 debugMode = true;
                 logger::setOutLogFile(false);
             }
+
+            else if(arg == "--headless") {
+                headless = true;
+            }
+
+            else if(arg == "--frames" && *(it + 1)) {
+                frameLimit = std::max(0, std::atoi(*(++it)));
+            }
+
+            else if(arg == "--record" && *(it + 1)) {
+                recordPath = *(++it);
+            }
+
+            else if(arg == "--stats" && *(it + 1)) {
+                statsPath = *(++it);
+            }
+
+            else if(arg == "--no-atlas") {
+                noAtlas = true;
+            }
         }
 
         return false;
@@ -64,13 +102,18 @@ bool App::initApp(const char* name, const char* version,
 
     if (isInitSuccess) return true;
 
-    if (parseArgs(args, _debugMode, name, version)) return true;
+    if (parseArgs(args, _debugMode, _headless, _frameLimit, _recordPath, _statsPath, _noAtlas, name, version)) return true;
 
     _name = name;
     _version = version;
 
     showStats = false;
 
+    // Hosts without a display can still create contexts through OSMesa on the null platform
+    #ifdef GLFW_PLATFORM_NULL
+        if (_headless) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    #endif
+
     // Initialize SDL
 	if (glfwInit() != GLFW_TRUE) return false;
 
@@ -86,12 +129,22 @@ bool App::initApp(const char* name, const char* version,
     glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
     glfwWindowHint(GLFW_DECORATED, GL_FALSE);
 
+    if (_headless) {
+        // software rasterizers don't always expose 4.6, default shaders only need 3.3
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+
+        #ifdef GLFW_PLATFORM_NULL
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        #endif
+    }
+
     // Create the main window for application
     #ifdef _WIN32
         SetProcessDPIAware();
     #endif
     
-    focusedWindow = std::make_shared<Window>(name, width, height);
+    focusedWindow = std::make_shared<Window>(name, width, height, _headless);
 
     if (!focusedWindow) return false;
 
@@ -102,19 +155,23 @@ bool App::initApp(const char* name, const char* version,
     // initialize modules
     input::init(focusedWindow->getGLFWWindow());
     timer::init();
+    jobs::init();
+    capture::init();
+    debugdraw::init();
+    renderer::init();
     fonts::init(std::string(resourcesFolderPath) + "fonts", defaultFontName, defaultFontSize);
-	engine::init(std::string(resourcesFolderPath) + "images");
+	engine::init(std::string(resourcesFolderPath) + "images", !_noAtlas);
 
     // Create timers
     sessionTimer = timer::createTimer();
-    frameTimer = timer::createTimer();
 
     currentFPS = 0;
     lastFPS = 0;
     checkPoint = 0;
+    frameCount = 0;
 
     // Stats panel - semi-transparent background of stats
-	unsigned int statsPanelID = engine::registerObject("stats_panel", make<Object>(ObjectType::HUD_ELEMENT, 0, 0, 300, 135, 0));
+	unsigned int statsPanelID = engine::registerObject("stats_panel", make<Object>(ObjectType::HUD_ELEMENT, 0, 0, 300, 215, 0));
 	engine::getObject(statsPanelID)->closeAnimation();
 	engine::getObject(statsPanelID)->setAllColors(0, 0, 0, 0.5);
 	engine::getObject(statsPanelID)->setVisibility(false);
@@ -123,10 +180,13 @@ bool App::initApp(const char* name, const char* version,
 }
 
 void App::destroyApp() {
+    capture::destroy();
     fonts::destroy();
+    jobs::destroy();
+    textures::destroy();
 
     timer::killTimer(sessionTimer);
-    timer::killTimer(frameTimer);
+    timer::destroy();
 
     isInitSuccess = false;
 
@@ -157,16 +217,28 @@ int App::getFPS() {
     return lastFPS;
 }
 
-void App::startLoop(int fpsCap) {
+void App::startLoop(int fpsCap, int frameLimit) {
+    if (frameLimit == 0) frameLimit = _frameLimit;
+
+    frameCount = 0;
+    frameDeadline = timer::getNow();
+
+    if (!_recordPath.empty()) capture::startRecording(_recordPath, capture::getFormatFromPath(_recordPath));
+
     while (isRunning()) {
         // fetch events
+        benchmark::beginPhase(FramePhase::EVENTS);
         input::pollEvents();
 
-        // update and draw objects
+        // update and draw objects, the engine marks where drawing starts
         engine::drawAllObjects();
         App::drawStats();
 
+        // start read back before the back buffer is swapped
+        capture::captureFrame();
+
         // Render newly created frame
+        benchmark::beginPhase(FramePhase::SWAP);
         focusedWindow->renderFrame();
 
         // update frame count of last second
@@ -183,13 +255,20 @@ void App::startLoop(int fpsCap) {
 
         // sleep for remaining time to cap frames
         if (fpsCap != 0 && !focusedWindow->isVsyncOn()) {
-            double maxDelay = 1000.0 / fpsCap;
+            double interval = 1000.0 / fpsCap;
+            double now = timer::getNow();
 
-            timer::delay((maxDelay - timer::getTimeDiff(frameTimer)));
-            timer::resetTimer(frameTimer);
+            // deadlines are absolute so oversleeping one frame is paid back by the next one,
+            // but after a long stall (loading, dragging the window) start over instead of rushing frames
+            frameDeadline += interval;
+            if (frameDeadline < now - interval) frameDeadline = now;
+
+            benchmark::beginPhase(FramePhase::WAIT);
+            timer::sleepUntil(frameDeadline);
         }
 
         // Clear Frame
+        benchmark::beginPhase(FramePhase::DRAW);
         focusedWindow->clearFrame();
 
         // Check if an OpenGL error occurred
@@ -199,7 +278,29 @@ void App::startLoop(int fpsCap) {
 
         // Benchmark
         benchmark::countFrames();
+
+        frameCount++;
+
+        if (frameLimit != 0 && frameCount >= (unsigned long long)frameLimit) break;
     }
+
+    capture::stopRecording();
+
+    if (!_statsPath.empty()) benchmark::exportStats(_statsPath);
+}
+
+void App::setHeadless(bool headless) {
+    if (isInitSuccess) return; // window already created
+
+    _headless = headless;
+}
+
+bool App::isHeadless() {
+    return _headless;
+}
+
+unsigned long long App::getFrameCount() {
+    return frameCount;
 }
 
 void App::changeFocus(std::shared_ptr<Window> newWindow) {
@@ -237,6 +338,30 @@ void App::drawStats() {
 
     text::setRendererY(110.0f);
     text::renderText(DEF_FONT, "Object Count: " + std::to_string(engine::getTotalObjectCount()-1)); // don't count stats panel
+
+    // percentiles over the last frames show hitches that the average hides
+    FrameTimeStats frameStats = benchmark::getFrameStats();
+
+    text::setRendererY(130.0f);
+    text::renderText(DEF_FONT, "p50/p95/p99: " + benchmark::applyPrecision(frameStats.p50, 2) + " / "
+        + benchmark::applyPrecision(frameStats.p95, 2) + " / " + benchmark::applyPrecision(frameStats.p99, 2) + "ms");
+
+    text::setRendererY(150.0f);
+    text::renderText(DEF_FONT, "Max Frame Time: " + benchmark::applyPrecision(frameStats.max, 3) + "ms");
+
+    // average time of every phase, three on the first line and the rest on the second
+    std::string phases[2] = {"Phases:", "Phases:"};
+
+    for (unsigned int i = 0; i < (unsigned int)FramePhase::COUNT; i++) {
+        FramePhase phase = (FramePhase)i;
+        phases[i / 3] += std::string(" ") + benchmark::getPhaseName(phase) + " " + benchmark::applyPrecision(benchmark::getPhaseStats(phase).average, 2) + "ms";
+    }
+
+    text::setRendererY(170.0f);
+    text::renderText(DEF_FONT, phases[0]);
+
+    text::setRendererY(190.0f);
+    text::renderText(DEF_FONT, phases[1]);
 }
 
 bool App::isShowingStats() {
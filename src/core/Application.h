@@ -5,6 +5,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 
 #define WINDOW_WIDTH App::getFocusedWindow()->getWidth()
 #define WINDOW_HEIGHT App::getFocusedWindow()->getHeight()
@@ -78,8 +79,27 @@ public:
      * @brief Starts game loop
      * 
      * @param fpsCap set how many times swap buffers for a second. Leave empty or set 0 to not limit fps
+     * @param frameLimit exits the loop after rendering this many frames. Leave empty or set 0 to use --frames argument or run until the window is closed
      */
-    static void startLoop(int fpsCap = 0);
+    static void startLoop(int fpsCap = 0, int frameLimit = 0);
+
+    /**
+     * @brief Makes the application render into an offscreen framebuffer of an invisible window.
+     * Must be called before initApp. Same as passing --headless argument.
+     * 
+     * @param headless True to run without a display.
+     */
+    static void setHeadless(bool headless);
+
+    /**
+     * @brief Checks if the application is running without a visible window.
+     */
+    static bool isHeadless();
+
+    /**
+     * @brief Gets how many frames rendered since the loop started.
+     */
+    static unsigned long long getFrameCount();
 
     /**
      * @brief Change the focused window
@@ -106,7 +126,7 @@ public:
 
 private:
     static int sessionTimer;
-    static int frameTimer; /**< this will reset every time when buffers swapped except vsync is on and fps cap is off. */
+    static double frameDeadline; /**< the time the next frame should start at when fps is capped, advanced by one frame interval per frame. */
 
     static double checkPoint; /**< indicates one second before sessionTimer, used on fps counting. */
 
@@ -117,6 +137,13 @@ private:
     static const char* _version;
 
     static bool _debugMode; /**< Internal variable indicating whether debug mode is enabled. */
+    static bool _headless; /**< Renders into an offscreen framebuffer instead of a visible window. */
+
+    static int _frameLimit; /**< frame count given with --frames argument, 0 means no limit. */
+    static std::string _recordPath; /**< output given with --record argument, empty means no recording. */
+    static std::string _statsPath; /**< output given with --stats argument, frame statistics are written there when the loop ends. */
+    static bool _noAtlas; /**< sprites are kept as separate textures when --no-atlas is given. */
+    static unsigned long long frameCount;
 
     static bool showStats;
 
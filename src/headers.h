@@ -1,9 +1,19 @@
+#include "sys/Animator.h"
+#include "sys/Capture.h"
+#include "sys/Collision.h"
+#include "sys/DebugDraw.h"
 #include "sys/Engine.h"
 #include "sys/Events.h"
 #include "sys/Files.h"
+#include "sys/Jobs.h"
 #include "sys/Logger.h"
 #include "sys/Physics.h"
+#include "sys/Renderer.h"
+#include "sys/Scheduler.h"
+#include "sys/Solver.h"
 #include "sys/TextRendering.h"
+#include "sys/Tween.h"
+#include "sys/Textures.h"
 #include "sys/Timer.h"
 
 #include "util/Object.h"
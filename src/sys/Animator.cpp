@@ -0,0 +1,83 @@
+#include "Animator.h"
+
+#include <vector>
+
+namespace {
+    std::vector<AnimationState> states;
+    std::vector<unsigned int> freeIndices; // removed states, reused before the array grows
+
+    unsigned int lastUpdateCount = 0;
+}
+
+unsigned int animator::add(float frameTime) {
+    AnimationState state = {0, 0, 0.0f, frameTime, ANIMATION_ALIVE};
+
+    if (!freeIndices.empty()) {
+        unsigned int index = freeIndices.back();
+        freeIndices.pop_back();
+
+        states[index] = state;
+        return index;
+    }
+
+    states.push_back(state);
+    return states.size() - 1;
+}
+
+void animator::remove(unsigned int index) {
+    states[index].flags = 0;
+    freeIndices.push_back(index);
+}
+
+AnimationState& animator::getState(unsigned int index) {
+    return states[index];
+}
+
+void animator::markVisible(unsigned int index) {
+    states[index].flags |= ANIMATION_VISIBLE;
+}
+
+void animator::advance(AnimationState& state, float milliseconds) {
+    if (state.frameCount <= 1 || (state.flags & ANIMATION_FINISHED)) return; // nothing to switch
+
+    state.accumulator += milliseconds;
+    if (state.accumulator < state.frameTime) return;
+
+    // a long frame can cover more than one keyframe
+    unsigned int steps = (unsigned int)(state.accumulator / state.frameTime);
+    state.accumulator -= steps * state.frameTime;
+
+    unsigned int next = state.frame + steps;
+
+    // restart or stop the animation if it has reached the end
+    if (next >= state.frameCount) {
+        if (state.flags & ANIMATION_LOOPING) {
+            next %= state.frameCount;
+        } else {
+            next = state.frameCount - 1;
+            state.accumulator = 0.0f;
+            state.flags |= ANIMATION_FINISHED;
+        }
+    }
+
+    state.frame = next;
+}
+
+void animator::update(double milliseconds) {
+    unsigned int count = 0;
+
+    for (auto& state : states) {
+        if (!(state.flags & ANIMATION_VISIBLE)) continue;
+
+        advance(state, (float)milliseconds);
+        state.flags &= ~ANIMATION_VISIBLE;
+
+        count++;
+    }
+
+    lastUpdateCount = count;
+}
+
+unsigned int animator::getLastUpdateCount() {
+    return lastUpdateCount;
+}
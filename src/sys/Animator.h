@@ -0,0 +1,63 @@
+#pragma once
+
+#define ANIMATION_LOOPING 1
+#define ANIMATION_FINISHED 2
+#define ANIMATION_VISIBLE 4 // set by the objects drawn this frame, cleared after the update
+#define ANIMATION_ALIVE 8
+
+/**
+ * @brief Playback state of one animation. Kept in a packed array so all animations advance in one pass.
+ */
+struct AnimationState {
+    unsigned int frame; /**< index of the current keyframe. */
+    unsigned int frameCount;
+    float accumulator; /**< milliseconds since the current keyframe started. */
+    float frameTime; /**< milliseconds per keyframe. */
+    unsigned int flags;
+};
+
+/**
+ * @brief Advances every animation from one frame clock. Animations of objects that weren't visible this frame are skipped.
+ */
+namespace animator {
+    /**
+     * @brief Creates the state of a new animation.
+     *
+     * @param frameTime Milliseconds per keyframe.
+     * @return The index of the state, stays the same until it is removed.
+     */
+    unsigned int add(float frameTime);
+
+    /**
+     * @brief Frees the state, its index can be given to a new animation.
+     */
+    void remove(unsigned int index);
+
+    AnimationState& getState(unsigned int index);
+
+    /**
+     * @brief Marks the animation to be advanced in the next update.
+     */
+    void markVisible(unsigned int index);
+
+    /**
+     * @brief Moves a state forward in time. Skips as many keyframes as the time covers.
+     *
+     * @param state The state to advance.
+     * @param milliseconds The time passed.
+     */
+    void advance(AnimationState& state, float milliseconds);
+
+    /**
+     * @brief Advances all visible animations and clears their visible flags.
+     * WARNING: This function is called automatically per frame by the engine.
+     *
+     * @param milliseconds The time since the last update.
+     */
+    void update(double milliseconds);
+
+    /**
+     * @brief Gets how many animations were advanced in the last update.
+     */
+    unsigned int getLastUpdateCount();
+}
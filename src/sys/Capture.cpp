@@ -0,0 +1,410 @@
+#include "Capture.h"
+
+#include "Logger.h"
+#include "Files.h"
+
+#include "../core/Application.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <condition_variable>
+
+#include <glad/glad.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#define MAX_QUEUED_CAPTURES 64
+
+namespace {
+    enum class JobType {
+        SCREENSHOT,
+        RECORDING_FRAME,
+        CLOSE_RECORDING
+    };
+
+    struct CaptureJob {
+        JobType type;
+        CaptureFormat format;
+        std::string path;
+        int width;
+        int height;
+        int fps;
+        std::vector<unsigned char> pixels; // RGBA8, bottom row first as OpenGL returns it
+    };
+
+    struct PixelSlot {
+        unsigned int pbo;
+        size_t capacity;
+        GLsync fence;
+        bool pending;
+        CaptureJob job; // everything except pixels, filled when the slot is mapped
+    };
+
+    // render thread
+    std::vector<PixelSlot> slots;
+    size_t writeSlot; // next slot to start a read back into
+    size_t readSlot; // oldest pending read back
+
+    std::vector<std::string> requestedScreenshots;
+
+    bool recording = false;
+    CaptureFormat recordingFormat;
+    std::string recordingPath;
+    int recordingFps;
+
+    std::atomic<unsigned int> droppedFrames;
+
+    // writer thread
+    std::thread writerThread;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<CaptureJob> jobQueue;
+    bool stopWriter;
+
+    std::ofstream recordingStream;
+    int streamWidth, streamHeight;
+    unsigned long long writtenFrames;
+
+    bool isInitialized = false;
+
+    // Helper function to create parent folders of an output path
+    std::string prepareOutputPath(const std::string& path) {
+        std::string nPath = files::normalizePath(path);
+        std::filesystem::path parent = std::filesystem::path(nPath).parent_path();
+
+        if (!parent.empty()) std::filesystem::create_directories(parent);
+
+        return nPath;
+    }
+
+    void writePNG(const std::string& path, const CaptureJob& job) {
+        stbi_flip_vertically_on_write(1);
+
+        if (!stbi_write_png(prepareOutputPath(path).c_str(), job.width, job.height, 4, job.pixels.data(), job.width * 4))
+            logError("Failed to write capture: " + path, CAPTURE_WRITE_ERROR);
+    }
+
+    void writeRAW(const CaptureJob& job) {
+        size_t rowSize = job.width * 4;
+
+        for (int y = job.height - 1; y >= 0; y--)
+            recordingStream.write((const char*)&job.pixels[y * rowSize], rowSize);
+    }
+
+    // Converts to full range BT.601 4:2:0 (C420jpeg)
+    void writeY4M(const CaptureJob& job) {
+        int w = job.width;
+        int h = job.height;
+        int cw = (w + 1) / 2;
+        int ch = (h + 1) / 2;
+
+        std::vector<unsigned char> planes(w * h + cw * ch * 2);
+        unsigned char* yPlane = planes.data();
+        unsigned char* uPlane = yPlane + w * h;
+        unsigned char* vPlane = uPlane + cw * ch;
+
+        auto pixel = [&](int x, int y) {
+            // flip rows, y4m wants the top row first
+            return &job.pixels[((h - 1 - y) * w + x) * 4];
+        };
+
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                const unsigned char* p = pixel(x, y);
+                yPlane[y * w + x] = (unsigned char)std::clamp(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2] + 0.5f, 0.0f, 255.0f);
+            }
+        }
+
+        for (int y = 0; y < ch; y++) {
+            for (int x = 0; x < cw; x++) {
+                float r = 0, g = 0, b = 0;
+
+                // average the 2x2 block, edges reuse the last row/column
+                for (int i = 0; i < 4; i++) {
+                    const unsigned char* p = pixel(std::min(x * 2 + (i & 1), w - 1), std::min(y * 2 + (i >> 1), h - 1));
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+
+                r *= 0.25f;
+                g *= 0.25f;
+                b *= 0.25f;
+
+                uPlane[y * cw + x] = (unsigned char)std::clamp(-0.168736f * r - 0.331264f * g + 0.5f * b + 128.5f, 0.0f, 255.0f);
+                vPlane[y * cw + x] = (unsigned char)std::clamp(0.5f * r - 0.418688f * g - 0.081312f * b + 128.5f, 0.0f, 255.0f);
+            }
+        }
+
+        recordingStream << "FRAME\n";
+        recordingStream.write((const char*)planes.data(), planes.size());
+    }
+
+    void writeRecordingFrame(const CaptureJob& job) {
+        if (job.format == CaptureFormat::PNG) {
+            std::string prefix = std::filesystem::path(job.path).replace_extension("").string();
+            writePNG(prefix + "_" + std::to_string(writtenFrames++) + ".png", job);
+            return;
+        }
+
+        if (!recordingStream.is_open()) {
+            recordingStream.open(prepareOutputPath(job.path), std::ios::binary | std::ios::trunc);
+
+            if (!recordingStream.is_open()) {
+                logError("Failed to open recording: " + job.path, CAPTURE_WRITE_ERROR);
+                return;
+            }
+
+            streamWidth = job.width;
+            streamHeight = job.height;
+
+            if (job.format == CaptureFormat::Y4M) {
+                recordingStream << "YUV4MPEG2 W" << job.width << " H" << job.height << " F" << job.fps << ":1 Ip A1:1 C420jpeg\n";
+            }
+        }
+
+        // streams can't change size in the middle
+        if (job.width != streamWidth || job.height != streamHeight) return;
+
+        if (job.format == CaptureFormat::Y4M) writeY4M(job);
+        else writeRAW(job);
+
+        writtenFrames++;
+    }
+
+    void writerLoop() {
+        while (true) {
+            CaptureJob job;
+
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [] { return stopWriter || !jobQueue.empty(); });
+
+                if (jobQueue.empty()) return; // stopping and nothing left to write
+
+                job = std::move(jobQueue.front());
+                jobQueue.pop_front();
+            }
+
+            switch (job.type) {
+                case JobType::SCREENSHOT:
+                    writePNG(job.path, job);
+                    break;
+
+                case JobType::RECORDING_FRAME:
+                    writeRecordingFrame(job);
+                    break;
+
+                case JobType::CLOSE_RECORDING:
+                    if (recordingStream.is_open()) recordingStream.close();
+                    writtenFrames = 0;
+                    break;
+            }
+        }
+    }
+
+    void pushJob(CaptureJob&& job) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+
+            // never let a slow disk block the renderer, close jobs must always get through
+            if (job.type != JobType::CLOSE_RECORDING && jobQueue.size() >= MAX_QUEUED_CAPTURES) {
+                droppedFrames++;
+                return;
+            }
+
+            jobQueue.push_back(std::move(job));
+        }
+
+        queueCondition.notify_one();
+    }
+
+    // Maps the oldest read back and sends its pixels to the writer thread
+    bool collectSlot(bool wait) {
+        PixelSlot& slot = slots[readSlot];
+
+        if (!slot.pending) return false;
+
+        GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+        glDeleteSync(slot.fence);
+        slot.fence = 0;
+
+        size_t size = (size_t)slot.job.width * slot.job.height * 4;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+
+        if (data) {
+            CaptureJob job = slot.job;
+            job.pixels.assign((unsigned char*)data, (unsigned char*)data + size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+            pushJob(std::move(job));
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.pending = false;
+        readSlot = (readSlot + 1) % slots.size();
+
+        return true;
+    }
+
+    void readFrame(const CaptureJob& job) {
+        PixelSlot& slot = slots[writeSlot];
+
+        // every buffer is still in flight
+        if (slot.pending) {
+            droppedFrames++;
+            return;
+        }
+
+        size_t size = (size_t)job.width * job.height * 4;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+        if (slot.capacity < size) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+            slot.capacity = size;
+        }
+
+        glReadBuffer(App::getFocusedWindow()->isHeadless() ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, job.width, job.height, GL_RGBA, GL_UNSIGNED_BYTE, 0); // returns immediately, copy happens on the GPU
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.pending = true;
+        slot.job = job;
+
+        writeSlot = (writeSlot + 1) % slots.size();
+    }
+
+    // Blocks until every read back is handed to the writer
+    void drainSlots() {
+        while (collectSlot(true));
+    }
+}
+
+void capture::init(int ringSize) {
+    if (isInitialized) return;
+
+    slots.resize(std::max(ringSize, 2));
+
+    for (auto& slot : slots) {
+        glGenBuffers(1, &slot.pbo);
+        slot.capacity = 0;
+        slot.fence = 0;
+        slot.pending = false;
+    }
+
+    writeSlot = 0;
+    readSlot = 0;
+    droppedFrames = 0;
+
+    stopWriter = false;
+    writtenFrames = 0;
+    writerThread = std::thread(writerLoop);
+
+    isInitialized = true;
+}
+
+void capture::destroy() {
+    if (!isInitialized) return;
+
+    stopRecording();
+    drainSlots();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWriter = true;
+    }
+
+    queueCondition.notify_one();
+    writerThread.join();
+
+    for (auto& slot : slots) glDeleteBuffers(1, &slot.pbo);
+    slots.clear();
+
+    isInitialized = false;
+}
+
+void capture::takeScreenshot(const std::string& path) {
+    requestedScreenshots.push_back(path);
+}
+
+void capture::startRecording(const std::string& path, CaptureFormat format, int fps) {
+    if (recording) stopRecording();
+
+    recording = true;
+    recordingFormat = format;
+    recordingPath = path;
+    recordingFps = fps;
+}
+
+void capture::stopRecording() {
+    if (!recording) return;
+
+    recording = false;
+
+    if (!isInitialized) return;
+
+    drainSlots();
+
+    CaptureJob job;
+    job.type = JobType::CLOSE_RECORDING;
+    pushJob(std::move(job));
+}
+
+bool capture::isRecording() { return recording; }
+unsigned int capture::getDroppedFrames() { return droppedFrames; }
+
+void capture::captureFrame() {
+    if (!isInitialized) return;
+
+    // hand over every read back that finished without waiting for the GPU
+    while (collectSlot(false));
+
+    if (!recording && requestedScreenshots.empty()) return;
+
+    CaptureJob job;
+    job.width = App::getFocusedWindow()->getWidth();
+    job.height = App::getFocusedWindow()->getHeight();
+
+    if (recording) {
+        job.type = JobType::RECORDING_FRAME;
+        job.format = recordingFormat;
+        job.path = recordingPath;
+        job.fps = recordingFps;
+        readFrame(job);
+    }
+
+    for (auto& path : requestedScreenshots) {
+        job.type = JobType::SCREENSHOT;
+        job.format = CaptureFormat::PNG;
+        job.path = path;
+        readFrame(job);
+    }
+
+    requestedScreenshots.clear();
+}
+
+CaptureFormat capture::getFormatFromPath(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    if (extension == ".y4m") return CaptureFormat::Y4M;
+    if (extension == ".raw") return CaptureFormat::RAW;
+
+    return CaptureFormat::PNG;
+}
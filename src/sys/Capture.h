@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+
+enum class CaptureFormat {
+    PNG, // numbered png sequence, path is used as prefix
+    RAW, // headerless RGBA8 frames, top row first
+    Y4M // YUV4MPEG2 stream with 4:2:0 chroma, playable by ffmpeg/mpv
+};
+
+/**
+ * @brief Screenshot and gameplay recording. Frames are read back through a ring of pixel buffer objects
+ * a few frames late and written to disk on a separate thread, so capturing never stalls the renderer.
+ */
+namespace capture {
+    /**
+     * @brief Creates the pixel buffer ring and starts the writer thread.
+     *
+     * @param ringSize How many frames a read back can stay in flight before it is mapped.
+     */
+    void init(int ringSize = 3);
+
+    /**
+     * @brief Waits for pending frames to be written, stops the writer thread and deletes the pixel buffers.
+     */
+    void destroy();
+
+    /**
+     * @brief Captures the next rendered frame into a png file.
+     *
+     * @param path The path of the png file.
+     */
+    void takeScreenshot(const std::string& path);
+
+    /**
+     * @brief Starts capturing every rendered frame.
+     *
+     * @param path The path of the output file. Used as file name prefix for png sequences.
+     * @param format The format of the output.
+     * @param fps The frame rate written into the stream header.
+     */
+    void startRecording(const std::string& path, CaptureFormat format, int fps = 60);
+
+    /**
+     * @brief Stops recording and closes the output once all pending frames are written.
+     */
+    void stopRecording();
+
+    /**
+     * @brief Checks if frames are being recorded.
+     */
+    bool isRecording();
+
+    /**
+     * @brief Starts read back of the current frame if a screenshot or recording needs it
+     * and hands finished read backs to the writer thread.
+     * WARNING: This function is called automatically by the Application before buffers are swapped.
+     */
+    void captureFrame();
+
+    /**
+     * @brief Gets how many frames were skipped because the pixel buffers or the writer queue were full.
+     */
+    unsigned int getDroppedFrames();
+
+    /**
+     * @brief Gets the capture format matching the extension of a path. (.y4m, .raw, png otherwise)
+     */
+    CaptureFormat getFormatFromPath(const std::string& path);
+}
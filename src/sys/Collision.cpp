@@ -0,0 +1,503 @@
+#include "Collision.h"
+
+#include "Engine.h"
+#include "Jobs.h"
+#include "Physics.h"
+
+#include "../classes/Entity.h"
+#include "../classes/Hitbox.h"
+#include "../util/Object.h"
+
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    std::vector<ContactManifold> contacts;
+
+    struct CachedContact {
+        ContactManifold manifold; // the latest one, exit events send it again
+        unsigned long long frame; // last update that found the pair touching
+        unsigned int ownerA, ownerB; // owners when the pair started touching, the parts may be gone at exit
+    };
+
+    // how many part pairs two owners touch with, an entity with two hitboxes on a wall still touches it once
+    struct OwnerContact {
+        unsigned int parts;
+        unsigned long long frame; // last update that sent an event for the owners
+    };
+
+    enum class ContactEvent { ENTER, STAY, EXIT };
+
+    struct PendingEvent {
+        ContactEvent event;
+        ContactManifold manifold;
+        unsigned int ownerA, ownerB;
+    };
+
+    // pairs touching since the last update, keyed by both IDs, smaller first
+    std::unordered_map<unsigned long long, CachedContact> contactCache;
+    std::unordered_map<unsigned long long, OwnerContact> ownerContacts;
+    std::vector<PendingEvent> contactEvents;
+    unsigned long long contactFrame = 0;
+
+    inline unsigned long long makePairKey(unsigned int idA, unsigned int idB) {
+        if (idA > idB) std::swap(idA, idB);
+        return ((unsigned long long)idA << 32) | idB;
+    }
+
+    // the entity that receives the callbacks of an object, hitboxes report to their parent
+    Entity* findEntity(unsigned int id, unsigned int& ownerID) {
+        const auto& objects = engine::getObjects();
+
+        auto it = objects.find(id);
+        if (it == objects.end() || it->second == nullptr) return nullptr;
+
+        ownerID = id;
+
+        if (it->second->getType() == ObjectType::HITBOX) {
+            ownerID = static_cast<const Hitbox&>(*it->second).getParentID();
+
+            it = objects.find(ownerID);
+            if (it == objects.end() || it->second == nullptr) return nullptr;
+        }
+
+        if (it->second->getType() != ObjectType::ENTITY) return nullptr;
+
+        return static_cast<Entity*>(it->second.get());
+    }
+
+    void dispatch(ContactEvent event, const ContactManifold& contact, unsigned int ownerA, unsigned int ownerB) {
+        unsigned int ignored;
+
+        Entity* entityA = findEntity(ownerA, ignored);
+        Entity* entityB = findEntity(ownerB, ignored);
+
+        // b sees the same contact from the other side
+        ContactManifold flipped = contact;
+        flipped.idA = contact.idB;
+        flipped.idB = contact.idA;
+        flipped.normalX = -contact.normalX;
+        flipped.normalY = -contact.normalY;
+
+        switch (event) {
+            case ContactEvent::ENTER:
+                if (entityA != nullptr) entityA->onCollisionEnter(ownerB, contact);
+                if (entityB != nullptr) entityB->onCollisionEnter(ownerA, flipped);
+                break;
+
+            case ContactEvent::STAY:
+                if (entityA != nullptr) entityA->onCollisionStay(ownerB, contact);
+                if (entityB != nullptr) entityB->onCollisionStay(ownerA, flipped);
+                break;
+
+            case ContactEvent::EXIT:
+                if (entityA != nullptr) entityA->onCollisionExit(ownerB);
+                if (entityB != nullptr) entityB->onCollisionExit(ownerA);
+                break;
+        }
+    }
+
+    // buffers of collidePairs, kept between frames
+    std::vector<ConvexShape> shapes;
+    std::vector<std::pair<unsigned int, unsigned int>> shapePairs;
+    std::vector<ContactManifold> pairResults;
+    std::vector<unsigned char> pairHits;
+    std::vector<std::pair<unsigned int, unsigned int>> orderedPairs; // sorted candidate pairs in deterministic mode
+
+    // the deepest point of b behind each edge of a, the largest of them is the best separating axis
+    float findMaxSeparation(const ConvexShape& a, const ConvexShape& b, unsigned int& edge) {
+        float best = -INFINITY;
+
+        for (unsigned int i = 0; i < a.count; i++) {
+            float deepest = INFINITY;
+
+            for (unsigned int j = 0; j < b.count; j++) {
+                float distance = a.normalX[i] * (b.x[j] - a.x[i]) + a.normalY[i] * (b.y[j] - a.y[i]);
+                deepest = std::min(deepest, distance);
+            }
+
+            if (deepest > best) {
+                best = deepest;
+                edge = i;
+            }
+        }
+
+        return best;
+    }
+
+    // keeps the part of the segment where dot(normal, p) <= offset, returns how many points are left
+    unsigned int clipSegment(const float inX[2], const float inY[2], float normalX, float normalY, float offset, float outX[2], float outY[2]) {
+        float distance0 = normalX * inX[0] + normalY * inY[0] - offset;
+        float distance1 = normalX * inX[1] + normalY * inY[1] - offset;
+
+        unsigned int count = 0;
+
+        if (distance0 <= 0.0f) { outX[count] = inX[0]; outY[count] = inY[0]; count++; }
+        if (distance1 <= 0.0f) { outX[count] = inX[1]; outY[count] = inY[1]; count++; }
+
+        if (distance0 * distance1 < 0.0f) {
+            float t = distance0 / (distance0 - distance1);
+            outX[count] = inX[0] + t * (inX[1] - inX[0]);
+            outY[count] = inY[0] + t * (inY[1] - inY[0]);
+            count++;
+        }
+
+        return count;
+    }
+}
+
+void collision::makePolygon(const float* pointsX, const float* pointsY, unsigned int count, ConvexShape& shape) {
+    count = std::min(count, (unsigned int)MAX_POLYGON_VERTICES);
+    shape.count = count;
+
+    float area = 0.0f;
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int next = (i + 1) % count;
+
+        shape.x[i] = pointsX[i];
+        shape.y[i] = pointsY[i];
+
+        area += pointsX[i] * pointsY[next] - pointsX[next] * pointsY[i];
+    }
+
+    // the right side of an edge is outside for one winding and inside for the other
+    float side = area >= 0.0f ? 1.0f : -1.0f;
+
+    shape.bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int next = (i + 1) % count;
+
+        float edgeX = shape.x[next] - shape.x[i];
+        float edgeY = shape.y[next] - shape.y[i];
+        float length = std::sqrt(edgeX * edgeX + edgeY * edgeY);
+
+        if (length > 0.0f) {
+            shape.normalX[i] = side * edgeY / length;
+            shape.normalY[i] = -side * edgeX / length;
+        }
+        else {
+            shape.normalX[i] = 0.0f;
+            shape.normalY[i] = 0.0f;
+        }
+
+        shape.bounds.minX = std::min(shape.bounds.minX, shape.x[i]);
+        shape.bounds.minY = std::min(shape.bounds.minY, shape.y[i]);
+        shape.bounds.maxX = std::max(shape.bounds.maxX, shape.x[i]);
+        shape.bounds.maxY = std::max(shape.bounds.maxY, shape.y[i]);
+    }
+}
+
+void collision::makeShape(const Object& object, ConvexShape& shape) {
+    float pointsX[MAX_POLYGON_VERTICES], pointsY[MAX_POLYGON_VERTICES];
+
+    if (object.getType() == ObjectType::HITBOX) {
+        const std::vector<glm::vec2>& polygon = static_cast<const Hitbox&>(object).getPolygon();
+
+        if (!polygon.empty()) {
+            // polygon points are relative to the top left corner, rotation goes around the center
+            Transform2D rotation = Transform2D::fromTRS(object.getX() + object.getWidth() / 2.0f, object.getY() + object.getHeight() / 2.0f, object.getAngle(), 1.0f, 1.0f);
+
+            unsigned int count = std::min((unsigned int)polygon.size(), (unsigned int)MAX_POLYGON_VERTICES);
+
+            for (unsigned int i = 0; i < count; i++) {
+                float localX = polygon[i].x - object.getWidth() / 2.0f;
+                float localY = polygon[i].y - object.getHeight() / 2.0f;
+
+                pointsX[i] = rotation.applyX(localX, localY);
+                pointsY[i] = rotation.applyY(localX, localY);
+            }
+
+            makePolygon(pointsX, pointsY, count, shape);
+            return;
+        }
+    }
+
+    Transform2D world = object.getTransform();
+
+    const float corners[4][2] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+
+    for (int i = 0; i < 4; i++) {
+        pointsX[i] = world.applyX(corners[i][0], corners[i][1]);
+        pointsY[i] = world.applyY(corners[i][0], corners[i][1]);
+    }
+
+    makePolygon(pointsX, pointsY, 4, shape);
+}
+
+bool collision::collide(const ConvexShape& a, const ConvexShape& b, ContactManifold& manifold) {
+    if (!a.bounds.overlaps(b.bounds)) return false;
+
+    unsigned int edgeA = 0, edgeB = 0;
+
+    float separationA = findMaxSeparation(a, b, edgeA);
+    if (separationA > 0.0f) return false;
+
+    float separationB = findMaxSeparation(b, a, edgeB);
+    if (separationB > 0.0f) return false;
+
+    // the face with the least overlap is the reference, a is preferred so results don't flicker
+    bool flip = separationB > separationA + 1e-3f;
+
+    const ConvexShape& reference = flip ? b : a;
+    const ConvexShape& incident = flip ? a : b;
+    unsigned int referenceEdge = flip ? edgeB : edgeA;
+
+    float normalX = reference.normalX[referenceEdge];
+    float normalY = reference.normalY[referenceEdge];
+
+    // the incident edge faces the reference edge the most
+    unsigned int incidentEdge = 0;
+    float minDot = INFINITY;
+
+    for (unsigned int i = 0; i < incident.count; i++) {
+        float dot = normalX * incident.normalX[i] + normalY * incident.normalY[i];
+
+        if (dot < minDot) {
+            minDot = dot;
+            incidentEdge = i;
+        }
+    }
+
+    float incidentX[2] = {incident.x[incidentEdge], incident.x[(incidentEdge + 1) % incident.count]};
+    float incidentY[2] = {incident.y[incidentEdge], incident.y[(incidentEdge + 1) % incident.count]};
+
+    float v1X = reference.x[referenceEdge], v1Y = reference.y[referenceEdge];
+    float v2X = reference.x[(referenceEdge + 1) % reference.count], v2Y = reference.y[(referenceEdge + 1) % reference.count];
+
+    float tangentX = v2X - v1X, tangentY = v2Y - v1Y;
+    float length = std::sqrt(tangentX * tangentX + tangentY * tangentY);
+    if (length <= 0.0f) return false;
+
+    tangentX /= length;
+    tangentY /= length;
+
+    // cut the incident edge to the sides of the reference edge
+    float clippedX[2], clippedY[2], finalX[2], finalY[2];
+
+    if (clipSegment(incidentX, incidentY, -tangentX, -tangentY, -(tangentX * v1X + tangentY * v1Y), clippedX, clippedY) < 2) return false;
+    if (clipSegment(clippedX, clippedY, tangentX, tangentY, tangentX * v2X + tangentY * v2Y, finalX, finalY) < 2) return false;
+
+    manifold.pointCount = 0;
+    manifold.depth = 0.0f;
+
+    // points behind the reference face are the contacts
+    for (int i = 0; i < 2; i++) {
+        float separation = normalX * (finalX[i] - v1X) + normalY * (finalY[i] - v1Y);
+        if (separation > 0.0f) continue;
+
+        unsigned int index = manifold.pointCount++;
+        manifold.pointX[index] = finalX[i];
+        manifold.pointY[index] = finalY[i];
+        manifold.pointDepth[index] = -separation;
+
+        manifold.depth = std::max(manifold.depth, -separation);
+    }
+
+    if (manifold.pointCount == 0) return false;
+
+    manifold.normalX = flip ? -normalX : normalX;
+    manifold.normalY = flip ? -normalY : normalY;
+
+    return true;
+}
+
+bool collision::raycast(const ConvexShape& shape, float x1, float y1, float x2, float y2, float& fraction, float& normalX, float& normalY) {
+    float dx = x2 - x1, dy = y2 - y1;
+
+    float lower = 0.0f, upper = 1.0f;
+    int entryEdge = -1;
+
+    // clip the segment to the inside of every edge
+    for (unsigned int i = 0; i < shape.count; i++) {
+        float numerator = shape.normalX[i] * (shape.x[i] - x1) + shape.normalY[i] * (shape.y[i] - y1);
+        float denominator = shape.normalX[i] * dx + shape.normalY[i] * dy;
+
+        if (denominator == 0.0f) {
+            if (numerator < 0.0f) return false; // parallel and outside
+            continue;
+        }
+
+        float t = numerator / denominator;
+
+        if (denominator < 0.0f && t > lower) {
+            lower = t;
+            entryEdge = i;
+        }
+        else if (denominator > 0.0f && t < upper) {
+            upper = t;
+        }
+
+        if (upper < lower) return false;
+    }
+
+    fraction = lower;
+
+    if (entryEdge >= 0) {
+        normalX = shape.normalX[entryEdge];
+        normalY = shape.normalY[entryEdge];
+    }
+    else {
+        // started inside, the normal faces back along the segment
+        float length = std::sqrt(dx * dx + dy * dy);
+        normalX = length > 0.0f ? -dx / length : 0.0f;
+        normalY = length > 0.0f ? -dy / length : 0.0f;
+    }
+
+    return true;
+}
+
+bool collision::overlapsCircle(const ConvexShape& shape, float x, float y, float radius) {
+    if (x + radius < shape.bounds.minX || x - radius > shape.bounds.maxX) return false;
+    if (y + radius < shape.bounds.minY || y - radius > shape.bounds.maxY) return false;
+
+    bool inside = true;
+    float closest = INFINITY;
+
+    for (unsigned int i = 0; i < shape.count; i++) {
+        unsigned int next = (i + 1) % shape.count;
+
+        if (shape.normalX[i] * (x - shape.x[i]) + shape.normalY[i] * (y - shape.y[i]) > 0.0f) inside = false;
+
+        // distance to the closest point of the edge
+        float edgeX = shape.x[next] - shape.x[i], edgeY = shape.y[next] - shape.y[i];
+        float lengthSquared = edgeX * edgeX + edgeY * edgeY;
+
+        float t = lengthSquared > 0.0f ? ((x - shape.x[i]) * edgeX + (y - shape.y[i]) * edgeY) / lengthSquared : 0.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+
+        float offsetX = x - (shape.x[i] + edgeX * t), offsetY = y - (shape.y[i] + edgeY * t);
+        closest = std::min(closest, offsetX * offsetX + offsetY * offsetY);
+    }
+
+    return inside || closest <= radius * radius;
+}
+
+void collision::collidePairs(const std::vector<std::pair<unsigned int, unsigned int>>& pairs, std::vector<ContactManifold>& result) {
+    result.clear();
+    if (pairs.empty()) return;
+
+    // every object gets its shape once, however many pairs it is in
+    std::unordered_map<unsigned int, unsigned int> shapeIndices;
+
+    shapes.clear();
+    shapePairs.resize(pairs.size());
+
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        unsigned int ids[2] = {pairs[i].first, pairs[i].second};
+        unsigned int indices[2];
+
+        for (int k = 0; k < 2; k++) {
+            auto [it, inserted] = shapeIndices.try_emplace(ids[k], shapes.size());
+
+            if (inserted) {
+                shapes.emplace_back();
+                makeShape(*engine::getObject(ids[k]), shapes.back());
+            }
+
+            indices[k] = it->second;
+        }
+
+        shapePairs[i] = {indices[0], indices[1]};
+    }
+
+    pairResults.resize(pairs.size());
+    pairHits.resize(pairs.size());
+
+    // pairs only read the shapes and write their own slot
+    jobs::parallelFor(pairs.size(), 64, [&](unsigned int begin, unsigned int end, unsigned int worker) {
+        for (unsigned int i = begin; i < end; i++) {
+            pairHits[i] = collide(shapes[shapePairs[i].first], shapes[shapePairs[i].second], pairResults[i]);
+        }
+    });
+
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        if (!pairHits[i]) continue;
+
+        pairResults[i].idA = pairs[i].first;
+        pairResults[i].idB = pairs[i].second;
+
+        result.push_back(pairResults[i]);
+    }
+}
+
+void collision::update() {
+    if (physics::isDeterministic()) {
+        // the broadphase can report pairs in any order, callbacks must not depend on it
+        orderedPairs = physics::getCandidatePairs();
+
+        for (auto& pair : orderedPairs)
+            if (pair.first > pair.second) std::swap(pair.first, pair.second);
+
+        std::sort(orderedPairs.begin(), orderedPairs.end());
+        collidePairs(orderedPairs, contacts);
+    } else {
+        collidePairs(physics::getCandidatePairs(), contacts);
+    }
+
+    contactFrame++;
+    contactEvents.clear();
+
+    for (const ContactManifold& contact : contacts) {
+        auto [it, inserted] = contactCache.try_emplace(makePairKey(contact.idA, contact.idB));
+        CachedContact& cached = it->second;
+
+        if (inserted) {
+            cached.ownerA = contact.idA;
+            cached.ownerB = contact.idB;
+
+            findEntity(contact.idA, cached.ownerA);
+            findEntity(contact.idB, cached.ownerB);
+        } else if (contact.idA != cached.manifold.idA) {
+            std::swap(cached.ownerA, cached.ownerB); // owners follow the order of the latest manifold
+        }
+
+        cached.manifold = contact;
+        cached.frame = contactFrame;
+
+        // owners enter when their first part pair does, and stay once per update however many parts touch
+        auto [owner, firstPart] = ownerContacts.try_emplace(makePairKey(cached.ownerA, cached.ownerB), OwnerContact{0, 0});
+        if (inserted) owner->second.parts++;
+
+        if (owner->second.frame == contactFrame) continue;
+        owner->second.frame = contactFrame;
+
+        contactEvents.push_back({firstPart ? ContactEvent::ENTER : ContactEvent::STAY, contact, cached.ownerA, cached.ownerB});
+    }
+
+    unsigned int firstExit = contactEvents.size();
+
+    // pairs that weren't found this frame stopped touching, owners exit with their last part pair
+    for (auto it = contactCache.begin(); it != contactCache.end();) {
+        CachedContact& cached = it->second;
+        if (cached.frame == contactFrame) { ++it; continue; }
+
+        auto owner = ownerContacts.find(makePairKey(cached.ownerA, cached.ownerB));
+
+        if (owner != ownerContacts.end() && --owner->second.parts == 0) {
+            contactEvents.push_back({ContactEvent::EXIT, cached.manifold, cached.ownerA, cached.ownerB});
+            ownerContacts.erase(owner);
+        }
+
+        it = contactCache.erase(it);
+    }
+
+    // the cache has no order of its own, exits are sorted like the contacts so every run calls them the same way
+    if (physics::isDeterministic()) {
+        std::sort(contactEvents.begin() + firstExit, contactEvents.end(), [](const PendingEvent& a, const PendingEvent& b) {
+            return makePairKey(a.ownerA, a.ownerB) < makePairKey(b.ownerA, b.ownerB);
+        });
+    }
+
+    // the cache is final before game code runs, callbacks can query it
+    for (const PendingEvent& pending : contactEvents) dispatch(pending.event, pending.manifold, pending.ownerA, pending.ownerB);
+}
+
+const std::vector<ContactManifold>& collision::getContacts() { return contacts; }
+
+bool collision::isTouching(unsigned int objectID1, unsigned int objectID2) {
+    unsigned long long key = makePairKey(objectID1, objectID2);
+    return contactCache.count(key) != 0 || ownerContacts.count(key) != 0;
+}
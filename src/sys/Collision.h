@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../util/AABB.h"
+
+#include <vector>
+#include <utility>
+
+#define MAX_POLYGON_VERTICES 8
+
+class Object;
+
+/**
+ * @brief Convex polygon in world coordinates, with the outward normal of every edge.
+ * Edge i goes from vertex i to vertex i + 1.
+ */
+struct ConvexShape {
+    unsigned int count;
+
+    float x[MAX_POLYGON_VERTICES], y[MAX_POLYGON_VERTICES];
+    float normalX[MAX_POLYGON_VERTICES], normalY[MAX_POLYGON_VERTICES];
+
+    AABB bounds;
+};
+
+/**
+ * @brief How two overlapping shapes touch.
+ */
+struct ContactManifold {
+    unsigned int idA, idB;
+
+    float normalX, normalY; /**< points from A to B. */
+    float depth; /**< how far the shapes overlap along the normal. */
+
+    unsigned int pointCount; /**< 1 or 2. */
+    float pointX[2], pointY[2]; /**< corners of one shape that are inside the other. */
+    float pointDepth[2];
+};
+
+/**
+ * @brief Narrowphase using the separating axis theorem. Works on rotated boxes and convex polygons.
+ */
+namespace collision {
+    /**
+     * @brief Builds a convex polygon from the points in local coordinates. Works with both windings.
+     *
+     * @param pointsX X coordinates of the points.
+     * @param pointsY Y coordinates of the points.
+     * @param count Number of points, 3 to MAX_POLYGON_VERTICES.
+     * @param shape The polygon.
+     */
+    void makePolygon(const float* pointsX, const float* pointsY, unsigned int count, ConvexShape& shape);
+
+    /**
+     * @brief Builds the world shape of an object. Hitboxes with a polygon use it, everything else is its rotated rectangle.
+     */
+    void makeShape(const Object& object, ConvexShape& shape);
+
+    /**
+     * @brief Tests two shapes for overlap.
+     *
+     * @param manifold Filled with the normal, depth and contact points if the shapes overlap. IDs are not set.
+     * @return True if the shapes overlap.
+     */
+    bool collide(const ConvexShape& a, const ConvexShape& b, ContactManifold& manifold);
+
+    /**
+     * @brief Finds where a segment enters a shape.
+     *
+     * @param fraction Where the segment hits, 0 at (x1, y1) and 1 at (x2, y2). 0 if it starts inside.
+     * @param normalX The x of the normal of the edge that was hit.
+     * @param normalY The y of the normal of the edge that was hit.
+     * @return True if the segment hits the shape.
+     */
+    bool raycast(const ConvexShape& shape, float x1, float y1, float x2, float y2, float& fraction, float& normalX, float& normalY);
+
+    /**
+     * @brief Checks if a circle overlaps a shape.
+     */
+    bool overlapsCircle(const ConvexShape& shape, float x, float y, float radius);
+
+    /**
+     * @brief Runs the narrowphase on many pairs of objects on all workers.
+     *
+     * @param pairs Pairs of object IDs, usually from the broadphase.
+     * @param contacts Filled with the manifolds of the pairs that overlap, in the order of the pairs.
+     */
+    void collidePairs(const std::vector<std::pair<unsigned int, unsigned int>>& pairs, std::vector<ContactManifold>& contacts);
+
+    /**
+     * @brief Finds the contacts of all broadphase pairs, compares them with the last frame
+     * and calls the collision callbacks of the entities involved.
+     * WARNING: This function is called automatically per frame by the engine.
+     */
+    void update();
+
+    /**
+     * @brief Gets the contacts found by the last update.
+     */
+    const std::vector<ContactManifold>& getContacts();
+
+    /**
+     * @brief Checks if two objects touched in the last update, without running the narrowphase again.
+     * Entities also count as touching when one of their hitboxes does.
+     */
+    bool isTouching(unsigned int objectID1, unsigned int objectID2);
+}
@@ -0,0 +1,195 @@
+#include "DebugDraw.h"
+
+#include "../util/renderer/Shaders.h"
+#include "../util/renderer/Buffers.h"
+#include "../util/renderer/DefaultShaders.h"
+
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+    std::vector<Vertex> screenVertices; // pairs of line end points in window coordinates
+    std::vector<Vertex> worldVertices; // pairs of line end points affected by camera
+
+    std::unique_ptr<Shaders> screenShaders;
+    std::unique_ptr<Shaders> worldShaders;
+
+    unsigned int VAO, VBO;
+    size_t bufferCapacity; // in vertices
+
+    glm::vec4 currentColor;
+    bool affectedByCamera;
+
+    unsigned int lastLineCount;
+
+    bool isInitialized = false;
+
+    void addVertex(float x, float y) {
+        auto& target = affectedByCamera ? worldVertices : screenVertices;
+        target.push_back({glm::vec3(x, y, 0.0f), currentColor, glm::vec2(0.0f, 0.0f)});
+    }
+
+    void drawVertices(const std::vector<Vertex>& vertices) {
+        if (vertices.empty()) return;
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        // orphan the old storage so the driver doesn't wait for last frame's draw
+        if (vertices.size() > bufferCapacity) bufferCapacity = vertices.size() * 2;
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+        glDrawArrays(GL_LINES, 0, (GLsizei)vertices.size());
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+}
+
+void debugdraw::init() {
+    if (isInitialized) return;
+
+    screenShaders = std::make_unique<Shaders>(defaultVertexShaderSource, defaultNoTextureFragmentShaderSource);
+    worldShaders = std::make_unique<Shaders>(defaultCameraVertexShaderSource, defaultNoTextureFragmentShaderSource);
+
+    bufferCapacity = 1024;
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    currentColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    affectedByCamera = false;
+    lastLineCount = 0;
+
+    isInitialized = true;
+}
+
+void debugdraw::setColor(float r, float g, float b, float a) { currentColor = glm::vec4(r/255.0f, g/255.0f, b/255.0f, a); }
+void debugdraw::setAffectedByCamera(bool affected) { affectedByCamera = affected; }
+
+void debugdraw::line(float x1, float y1, float x2, float y2) {
+    addVertex(x1, y1);
+    addVertex(x2, y2);
+}
+
+void debugdraw::rect(float x, float y, float width, float height, float angle) {
+    float centerX = x + width / 2.0f;
+    float centerY = y + height / 2.0f;
+
+    float c = std::cos(glm::radians(-angle));
+    float s = std::sin(glm::radians(-angle));
+
+    float corners[4][2];
+    float halfSizes[4][2] = {
+        {-width / 2.0f, -height / 2.0f},
+        { width / 2.0f, -height / 2.0f},
+        { width / 2.0f,  height / 2.0f},
+        {-width / 2.0f,  height / 2.0f}
+    };
+
+    for (int i = 0; i < 4; i++) {
+        corners[i][0] = centerX + halfSizes[i][0] * c - halfSizes[i][1] * s;
+        corners[i][1] = centerY + halfSizes[i][0] * s + halfSizes[i][1] * c;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        int next = (i + 1) % 4;
+        line(corners[i][0], corners[i][1], corners[next][0], corners[next][1]);
+    }
+}
+
+void debugdraw::circle(float centerX, float centerY, float radius, int segments) {
+    if (segments < 3) segments = 3;
+
+    float step = 2.0f * 3.14159265f / segments;
+
+    float lastX = centerX + radius;
+    float lastY = centerY;
+
+    for (int i = 1; i <= segments; i++) {
+        float x = centerX + radius * std::cos(step * i);
+        float y = centerY + radius * std::sin(step * i);
+
+        line(lastX, lastY, x, y);
+
+        lastX = x;
+        lastY = y;
+    }
+}
+
+void debugdraw::arrow(float x1, float y1, float x2, float y2, float headSize) {
+    line(x1, y1, x2, y2);
+
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float length = std::sqrt(dx * dx + dy * dy);
+
+    if (length == 0.0f) return;
+
+    // unit direction and its normal scaled to the head size
+    dx = dx / length * headSize;
+    dy = dy / length * headSize;
+
+    line(x2, y2, x2 - dx - dy * 0.5f, y2 - dy + dx * 0.5f);
+    line(x2, y2, x2 - dx + dy * 0.5f, y2 - dy - dx * 0.5f);
+}
+
+void debugdraw::flush(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) {
+    lastLineCount = (screenVertices.size() + worldVertices.size()) / 2;
+
+    if (!isInitialized) {
+        screenVertices.clear();
+        worldVertices.clear();
+        return;
+    }
+
+    glm::mat4 model(1.0f); // vertices are already in place
+
+    // without a camera world lines are drawn where they are on the screen
+    if (camera == nullptr && !worldVertices.empty()) {
+        screenVertices.insert(screenVertices.end(), worldVertices.begin(), worldVertices.end());
+        worldVertices.clear();
+    }
+
+    if (!screenVertices.empty()) {
+        glm::mat4 view = window->getProjectionMatrix();
+
+        screenShaders->activate();
+        screenShaders->setUniform("u_Model", (float*)&model, SHADER_MAT4);
+        screenShaders->setUniform("u_View", (float*)&view, SHADER_MAT4);
+
+        drawVertices(screenVertices);
+        screenVertices.clear();
+    }
+
+    if (!worldVertices.empty()) {
+        glm::mat4 view = camera->getViewMatrix();
+        glm::mat4 projection = camera->getProjectionMatrix();
+
+        worldShaders->activate();
+        worldShaders->setUniform("u_Model", (float*)&model, SHADER_MAT4);
+        worldShaders->setUniform("u_View", (float*)&view, SHADER_MAT4);
+        worldShaders->setUniform("u_Projection", (float*)&projection, SHADER_MAT4);
+
+        drawVertices(worldVertices);
+        worldVertices.clear();
+    }
+}
+
+unsigned int debugdraw::getLastLineCount() { return lastLineCount; }
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../util/Window.h"
+#include "../classes/Camera.h"
+
+#include <memory>
+
+/**
+ * @brief Immediate mode line renderer for hitboxes and gizmos.
+ * Primitives can be added from anywhere during the frame, they are gathered into one vertex stream
+ * and drawn with a single call per space when the frame ends.
+ */
+namespace debugdraw {
+    /**
+     * @brief Creates the vertex buffers and shaders of the debug renderer.
+     */
+    void init();
+
+    /**
+     * @brief Sets the color of the next primitives.
+     *
+     * @param r The red component of the color (0.0 - 255.0).
+     * @param g The green component of the color (0.0 - 255.0).
+     * @param b The blue component of the color (0.0 - 255.0).
+     * @param a The alpha component of the color (0.0 - 1.0).
+     */
+    void setColor(float r, float g, float b, float a = 1.0f);
+
+    /**
+     * @brief Sets if the next primitives are in world space and transformed by the camera, or in screen space.
+     *
+     * @param affected True for world space.
+     */
+    void setAffectedByCamera(bool affected);
+
+    void line(float x1, float y1, float x2, float y2);
+
+    /**
+     * @brief Adds the outline of a rectangle rotated around its center, same as an Object with these bounds.
+     */
+    void rect(float x, float y, float width, float height, float angle = 0.0f);
+
+    void circle(float centerX, float centerY, float radius, int segments = 24);
+
+    /**
+     * @brief Adds a line with an arrow head at (x2, y2).
+     */
+    void arrow(float x1, float y1, float x2, float y2, float headSize = 8.0f);
+
+    /**
+     * @brief Draws all primitives added in this frame and clears them.
+     * WARNING: This function is called automatically per frame by the engine.
+     *
+     * @param window The window to draw on.
+     * @param camera The camera to use for world space primitives.
+     */
+    void flush(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera);
+
+    /**
+     * @brief Gets how many lines were drawn in the last flush.
+     */
+    unsigned int getLastLineCount();
+}
@@ -3,7 +3,15 @@
 #include "Logger.h"
 #include "Files.h"
 #include "Physics.h"
+#include "Collision.h"
 #include "Timer.h"
+#include "DebugDraw.h"
+#include "Renderer.h"
+#include "Jobs.h"
+#include "Textures.h"
+#include "Animator.h"
+#include "Tween.h"
+#include "Scheduler.h"
 
 #include "../util/renderer/Shaders.h"
 #include "../util/renderer/Buffers.h"
@@ -12,10 +20,13 @@
 #include "../classes/Entity.h"
 #include "../classes/SubEntity.h"
 #include "../classes/NonEntity.h"
+#include "../classes/Skeleton.h"
+#include "../classes/Hitbox.h"
 
 #include "../core/Application.h"
 
 #include <map>
+#include <algorithm>
 #include <glad/glad.h>
 
 namespace {
@@ -28,9 +39,65 @@ namespace {
 
     std::shared_ptr<Camera> currentCamera;
     std::shared_ptr<Scene> currentScene;
+
+    std::vector<Object*> renderQueue; // objects in painter order, rebuilt every frame
+
+    struct Attachment {
+        unsigned int child, parent;
+        Object* childObject; // objects are never freed while registered, so no lookups per frame
+        Object* parentObject;
+
+        float localX, localY; // child center relative to the parent center, before the parent's rotation
+        float angleOffset;
+        bool followAngle;
+
+        unsigned int depth; // 0 if the parent isn't attached to anything
+    };
+
+    std::vector<Attachment> attachments; // parents before children once sorted
+    std::map<unsigned int, unsigned int> attachmentIndices; // child id, index in attachments
+    bool attachmentsSorted = true;
+
+    void sortAttachments() {
+        // depth of every chain, a parent is always less deep than its children
+        for (auto& attachment : attachments) {
+            attachment.depth = 0;
+
+            for (auto it = attachmentIndices.find(attachment.parent); it != attachmentIndices.end(); it = attachmentIndices.find(attachments[it->second].parent))
+                attachment.depth++;
+        }
+
+        std::stable_sort(attachments.begin(), attachments.end(), [](const Attachment& a, const Attachment& b) {
+            return a.depth < b.depth;
+        });
+
+        for (unsigned int i = 0; i < attachments.size(); i++) attachmentIndices[attachments[i].child] = i;
+
+        attachmentsSorted = true;
+    }
+
+    unsigned int frameTimerID;
+    double frameDelta = 0; // milliseconds between the last two frames
+
+    RenderContext createRenderContext() {
+        RenderContext context;
+
+        context.windowWidth = App::getFocusedWindow()->getWidth();
+        context.windowHeight = App::getFocusedWindow()->getHeight();
+
+        context.cameraX = currentCamera->getX();
+        context.cameraY = currentCamera->getY();
+        context.cameraZoom = currentCamera->getZoom();
+        context.cameraWidth = currentCamera->getWidth();
+        context.cameraHeight = currentCamera->getHeight();
+
+        context.showHitboxes = App::isShowingStats();
+
+        return context;
+    }
 }
 
-void engine::init(const std::string& imagesPath) {
+void engine::init(const std::string& imagesPath, bool packAtlas) {
     // TODO: add other buffer types
     bufferList.push_back(std::make_shared<Buffers>(4, 6)); // filled rectangular buff
     bufferList.push_back(std::make_shared<Buffers>(4, 8)); // empty rectangular buff
@@ -45,6 +112,16 @@ void engine::init(const std::string& imagesPath) {
         savedSpritePaths.insert(std::pair<std::string, std::string>(name, nPath));
     }
 
+    if (packAtlas) {
+        std::vector<std::string> spriteNames;
+        for (auto& [name, path] : savedSpritePaths) spriteNames.push_back(name);
+
+        unsigned int pageCount = textures::buildAtlas(spriteNames);
+        logInfo("Sprite atlas built with " + std::to_string(pageCount) + " pages for " + std::to_string(spriteNames.size()) + " sprites");
+    }
+
+    frameTimerID = timer::createTimer();
+
     // create default camera
     currentCamera = std::make_shared<Camera>(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, 1.0f);
 }
@@ -62,15 +139,115 @@ unsigned int engine::registerObject(const std::string& objName, cast<Object> obj
 
     object->setID(objID);
 
+    // hitboxes follow their parent from the start
+    if (object->getType() == ObjectType::HITBOX) {
+        cast<Hitbox> hitbox = std::static_pointer_cast<Hitbox>(object);
+
+        if (objectMap.count(hitbox->getParentID())) {
+            hitbox->syncCoordsWithParent();
+            attach(objID, hitbox->getParentID(), true);
+        }
+    }
+
     return objID;
 }
 
+bool engine::attach(unsigned int childID, unsigned int parentID, bool followAngle) {
+    auto child = objectMap.find(childID);
+    auto parent = objectMap.find(parentID);
+
+    if (childID == parentID || child == objectMap.end() || parent == objectMap.end()) return false;
+
+    // a parent that follows the child would make a loop
+    for (unsigned int id = parentID; id != 0; id = getParentID(id))
+        if (id == childID) return false;
+
+    detach(childID);
+
+    Object* childObject = child->second.get();
+    Object* parentObject = parent->second.get();
+
+    float offsetX = (childObject->getX() + childObject->getWidth() / 2.0f) - (parentObject->getX() + parentObject->getWidth() / 2.0f);
+    float offsetY = (childObject->getY() + childObject->getHeight() / 2.0f) - (parentObject->getY() + parentObject->getHeight() / 2.0f);
+
+    Attachment attachment = {childID, parentID, childObject, parentObject, offsetX, offsetY, 0.0f, followAngle, 0};
+
+    if (followAngle) {
+        // store the offset as if the parent wasn't turned
+        Transform2D undo = Transform2D::fromTRS(0.0f, 0.0f, -parentObject->getAngle(), 1.0f, 1.0f);
+
+        attachment.localX = undo.applyX(offsetX, offsetY);
+        attachment.localY = undo.applyY(offsetX, offsetY);
+        attachment.angleOffset = childObject->getAngle() - parentObject->getAngle();
+    }
+
+    attachmentIndices[childID] = attachments.size();
+    attachments.push_back(attachment);
+    attachmentsSorted = false;
+
+    return true;
+}
+
+void engine::detach(unsigned int childID) {
+    auto it = attachmentIndices.find(childID);
+    if (it == attachmentIndices.end()) return;
+
+    attachments.erase(attachments.begin() + it->second);
+    attachmentIndices.erase(it);
+
+    for (unsigned int i = 0; i < attachments.size(); i++) attachmentIndices[attachments[i].child] = i;
+    attachmentsSorted = false;
+}
+
+unsigned int engine::getParentID(unsigned int childID) {
+    auto it = attachmentIndices.find(childID);
+    return it == attachmentIndices.end() ? 0 : attachments[it->second].parent;
+}
+
+void engine::syncAttachments() {
+    if (!attachmentsSorted) sortAttachments();
+
+    for (const Attachment& attachment : attachments) {
+        Object* parent = attachment.parentObject;
+        Object* child = attachment.childObject;
+
+        float parentCenterX = parent->getX() + parent->getWidth() / 2.0f;
+        float parentCenterY = parent->getY() + parent->getHeight() / 2.0f;
+
+        float centerX = parentCenterX + attachment.localX;
+        float centerY = parentCenterY + attachment.localY;
+
+        if (attachment.followAngle) {
+            Transform2D world = Transform2D::fromTRS(parentCenterX, parentCenterY, parent->getAngle(), 1.0f, 1.0f);
+
+            centerX = world.applyX(attachment.localX, attachment.localY);
+            centerY = world.applyY(attachment.localX, attachment.localY);
+
+            float angle = parent->getAngle() + attachment.angleOffset;
+            if (child->getAngle() != angle) child->setRotation(angle);
+        }
+
+        // unchanged children stay out of the dirty list
+        float x = centerX - child->getWidth() / 2.0f;
+        float y = centerY - child->getHeight() / 2.0f;
+
+        if (child->getX() != x) child->setX(x);
+        if (child->getY() != y) child->setY(y);
+    }
+}
+
 std::shared_ptr<Buffers> engine::getBuffers(unsigned int bufferType) {
     return bufferList[bufferType];
 }
 
+double engine::getFrameDelta() { return frameDelta; }
+
 unsigned int engine::getTotalObjectCount() { return objectMap.size(); }
 
+const std::map<unsigned int, cast<Object>>& engine::getObjects() {
+    return objectMap;
+}
+
 cast<Object> engine::getObject(unsigned int objID) {
     return objectMap[objID];
 }
@@ -84,6 +261,12 @@ std::string engine::getObjectName(unsigned int objID) {
 }
 
 void engine::drawAllObjects() {
+    // one clock sample for the whole frame
+    timer::beginFrame();
+    benchmark::beginPhase(FramePhase::UPDATE);
+    frameDelta = timer::getFrameTimeDiff(frameTimerID);
+    timer::resetTimerToFrame(frameTimerID);
+
     // rendering queue
     auto layers = currentScene->getRenderingQueue();
 
@@ -94,6 +277,8 @@ void engine::drawAllObjects() {
     currentScene->events();
     currentScene->update(currentScene->getFrameTime());
 
+    renderQueue.clear();
+
     // reverse iterate through layers, so that the last(lower value) layer is drawn firsts
     for (auto i = layers.rbegin(); i != layers.rend(); i++) {
         auto obj = objectMap[i->second];
@@ -118,10 +303,64 @@ void engine::drawAllObjects() {
                 nonEntity->events();
                 break;
             }
+
+            default:
+                break;
         }
 
-        obj->draw(App::getFocusedWindow(), currentCamera);
+        renderQueue.push_back(obj.get());
     }
+
+    // physics enabled entities move after their own updates set velocities
+    physics::advance(frameDelta);
+
+    // tweens write through the setters, before the transforms are rebuilt
+    tween::update(frameDelta);
+
+    // delayed and repeating calls, they see the frame's movement and can still move things before the sync
+    scheduler::update(frameDelta);
+
+    // hitboxes and other children follow where physics and tweens put their parents
+    syncAttachments();
+
+    // everything that moved this frame gets its transform in one pass
+    Object::updateDirtyTransforms();
+
+    // collision pairs and queries see this frame's positions
+    physics::updateBroadphase();
+
+    // fixed ticks find their own contacts, per frame ones would depend on the frame rate
+    if (!physics::isDeterministic()) collision::update();
+
+    benchmark::beginPhase(FramePhase::DRAW);
+
+    RenderContext context = createRenderContext();
+
+    // advance the animations of objects on screen together
+    for (Object* obj : renderQueue) obj->stepAnimation(context);
+    animator::update(frameDelta);
+
+    // bone poses and sprite quads of all characters, sampled on the workers
+    Skeleton::updateAll(frameDelta, context);
+
+    // record draw commands in parallel, nothing touches OpenGL here
+
+    renderer::beginFrame();
+
+    jobs::parallelFor(renderQueue.size(), 256, [&](unsigned int begin, unsigned int end, unsigned int worker) {
+        CommandBuffer& commands = renderer::getCommandBuffer(worker);
+
+        for (unsigned int i = begin; i < end; i++) {
+            commands.beginObject(i);
+            renderQueue[i]->record(commands, context);
+        }
+    });
+
+    // replay on this thread
+    renderer::endFrame(App::getFocusedWindow(), currentCamera);
+
+    // hitboxes and gizmos gathered while drawing
+    debugdraw::flush(App::getFocusedWindow(), currentCamera);
 }
 
 std::string engine::getSpritePath(const std::string& spriteName) {
@@ -6,6 +6,7 @@
 #include "../classes/Camera.h"
 #include "../classes/Scene.h"
 
+#include <map>
 #include <vector>
 #include <memory>
 
@@ -25,8 +26,11 @@ typedef std::vector<std::string> SpriteList;
 namespace engine {
     /**
      * @brief The engine namespace contains functions and classes related to the game engine.
+     * 
+     * @param placeholderImagePath The folder that all sprites are saved from.
+     * @param packAtlas Whether to pack the sprites into shared atlas pages, so objects with different sprites can be batched.
      */
-    void init(const std::string& placeholderImagePath);
+    void init(const std::string& placeholderImagePath, bool packAtlas = true);
 
     /**
      * @brief Registers an object with the specified name and object.
@@ -37,6 +41,43 @@ namespace engine {
      */
     unsigned int registerObject(const std::string& objName, cast<Object> object);
 
+    /**
+     * @brief Makes an object follow another one. The child keeps its current place relative to the parent
+     * and is moved with it every frame after physics, parents before children. Hitboxes are attached
+     * to their parent automatically when they are registered.
+     * 
+     * @param childID The object that follows.
+     * @param parentID The object that is followed.
+     * @param followAngle Whether the child also turns with the parent, around the parent's center.
+     * @return True if attached, false if an object is missing or the parent already follows the child.
+     */
+    bool attach(unsigned int childID, unsigned int parentID, bool followAngle = true);
+
+    /**
+     * @brief Stops an object from following its parent. It stays where it is.
+     */
+    void detach(unsigned int childID);
+
+    /**
+     * @brief Gets the object a child follows.
+     * 
+     * @return The parent ID, or 0 if the object isn't attached.
+     */
+    unsigned int getParentID(unsigned int childID);
+
+    /**
+     * @brief Moves all attached objects to their parents.
+     * WARNING: This function is called automatically per frame by the engine.
+     */
+    void syncAttachments();
+
+    /**
+     * @brief Gets the time between the last two frames. All animations advance by this amount.
+     * 
+     * @return The frame time in milliseconds.
+     */
+    double getFrameDelta();
+
     /**
      * @brief Retrieves the total count of registered objects.
      * 
@@ -52,6 +93,13 @@ namespace engine {
      */
     std::shared_ptr<Buffers> getBuffers(unsigned int bufferType);
 
+    /**
+     * @brief Gets all registered objects, sorted by ID.
+     * 
+     * @return The map of object IDs to objects.
+     */
+    const std::map<unsigned int, cast<Object>>& getObjects();
+
     /**
      * @brief Retrieves an object with the specified ID.
      *
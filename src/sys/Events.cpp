@@ -1,6 +1,7 @@
 #include "Events.h"
 
 #include "Logger.h"
+#include "Capture.h"
 #include "../core/Application.h"
 
 #include <vector>
@@ -94,6 +95,9 @@ void callbacks::keyCallback(GLFWwindow* window, int key, int scancode, int actio
     if (action == GLFW_RELEASE) {
         if (key == GLFW_KEY_F3)
             App::toggleStats();
+
+        if (key == GLFW_KEY_F12)
+            capture::takeScreenshot("./captures/screenshot_" + std::to_string(App::getFrameCount()) + ".png");
     }
 }
 
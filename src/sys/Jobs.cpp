@@ -0,0 +1,129 @@
+#include "Jobs.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+
+namespace {
+    std::vector<std::thread> workers;
+
+    std::mutex jobMutex;
+    std::condition_variable jobCondition;
+    std::condition_variable doneCondition;
+
+    // current loop, replaced by every parallelFor call
+    const std::function<void(unsigned int, unsigned int, unsigned int)>* currentFunction = nullptr;
+    unsigned int currentCount;
+    unsigned int currentGrain;
+    std::atomic<unsigned int> nextIndex;
+
+    unsigned long long jobGeneration = 0; // increments when a new loop starts
+    unsigned int busyWorkers = 0;
+    bool stopping = false;
+
+    bool isInitialized = false;
+
+    // Takes ranges until the loop runs out of elements
+    void runRanges(unsigned int workerIndex) {
+        while (true) {
+            unsigned int begin = nextIndex.fetch_add(currentGrain);
+            if (begin >= currentCount) return;
+
+            unsigned int end = std::min(begin + currentGrain, currentCount);
+            (*currentFunction)(begin, end, workerIndex);
+        }
+    }
+
+    void workerLoop(unsigned int workerIndex) {
+        unsigned long long seenGeneration = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(jobMutex);
+                jobCondition.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+
+                if (stopping) return;
+
+                seenGeneration = jobGeneration;
+            }
+
+            runRanges(workerIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(jobMutex);
+                busyWorkers--;
+            }
+
+            doneCondition.notify_one();
+        }
+    }
+}
+
+void jobs::init(unsigned int threadCount) {
+    if (isInitialized) return;
+
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    stopping = false;
+
+    // main thread is the worker 0
+    for (unsigned int i = 1; i < threadCount; i++)
+        workers.emplace_back(workerLoop, i);
+
+    isInitialized = true;
+}
+
+void jobs::destroy() {
+    if (!isInitialized) return;
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+
+    jobCondition.notify_all();
+
+    for (auto& worker : workers) worker.join();
+    workers.clear();
+
+    isInitialized = false;
+}
+
+unsigned int jobs::getWorkerCount() {
+    return workers.size() + 1;
+}
+
+void jobs::parallelFor(unsigned int count, unsigned int grainSize, const std::function<void(unsigned int, unsigned int, unsigned int)>& function) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    // not worth waking anyone up
+    if (workers.empty() || count <= grainSize) {
+        function(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+
+        currentFunction = &function;
+        currentCount = count;
+        currentGrain = grainSize;
+        nextIndex = 0;
+
+        busyWorkers = workers.size();
+        jobGeneration++;
+    }
+
+    jobCondition.notify_all();
+
+    runRanges(0);
+
+    std::unique_lock<std::mutex> lock(jobMutex);
+    doneCondition.wait(lock, [] { return busyWorkers == 0; });
+
+    currentFunction = nullptr;
+}
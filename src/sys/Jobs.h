@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * @brief Fixed pool of worker threads for data parallel loops.
+ * Only the main thread should start jobs, it works on the loop too while it waits.
+ */
+namespace jobs {
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threadCount Total thread count including the main thread. Set 0 to use all hardware threads.
+     */
+    void init(unsigned int threadCount = 0);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    void destroy();
+
+    /**
+     * @brief Gets how many threads work on a loop, including the main thread.
+     * Use it to size per thread buffers.
+     */
+    unsigned int getWorkerCount();
+
+    /**
+     * @brief Splits [0, count) into ranges of at most grainSize elements and runs them on all workers.
+     * Returns when every range is done. Ranges taken by the same worker always come in increasing order.
+     *
+     * @param count The number of elements.
+     * @param grainSize The maximum number of elements in one range.
+     * @param function Called with (begin, end, workerIndex). workerIndex is less than getWorkerCount().
+     */
+    void parallelFor(unsigned int count, unsigned int grainSize, const std::function<void(unsigned int, unsigned int, unsigned int)>& function);
+}
@@ -102,6 +102,11 @@ void logger::printHelp() {
     std::cerr << "  -h, --help: Prints help(this) message." << std::endl;
     std::cerr << "  -v, --version: Prints version info." << std::endl;
     std::cerr << "  -d, --debug: Enables debug mode." << std::endl;
+    std::cerr << "  --headless: Renders into an offscreen framebuffer without showing a window." << std::endl;
+    std::cerr << "  --frames <count>: Exits after rendering the given number of frames." << std::endl;
+    std::cerr << "  --record <path>: Records every frame. (.y4m, .raw or numbered .png files)" << std::endl;
+    std::cerr << "  --stats <path>: Writes frame time percentiles, phase times and a frame time histogram as CSV on exit." << std::endl;
+    std::cerr << "  --no-atlas: Loads every sprite as a separate texture instead of packing them." << std::endl;
 }
 
 void logger::printVersion(const char* name, const char* version) {
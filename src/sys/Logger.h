@@ -18,6 +18,12 @@
 #define OPENAL_CONTEXT_CREATION_ERROR 13
 #define VERTEX_OR_INDEX_NULLPTR 14
 #define CHARACTER_NOT_FOUND 15
+#define FRAMEBUFFER_INCOMPLETE 16
+#define WINDOW_CREATION_ERROR 17
+#define CAPTURE_WRITE_ERROR 18
+#define INVALID_POLYGON 19
+#define OBJECT_NOT_FOUND 20
+#define INVALID_TWEEN_PROPERTY 21
 
 typedef int ErrorCode;
 
@@ -1,37 +1,695 @@
 #include "Physics.h"
 
 #include "Engine.h"
+#include "Collision.h"
+#include "Solver.h"
+#include "Jobs.h"
 
 #include "../classes/Entity.h"
+#include "../classes/Hitbox.h"
 #include "../util/Object.h"
+#include "../util/SpatialHash.h"
+#include "../util/AABBTree.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 namespace{
     float gravity = 0.0f;
+
+    PhysicsBodies bodies;
+    std::vector<unsigned int> freeBodies; // removed bodies, reused before the arrays grow
+
+    unsigned int lastStepCount = 0;
+
+    // every field of a body at once, so the arrays never get out of step
+    void resizeBodies(unsigned int size) {
+        bodies.owners.resize(size, nullptr);
+        bodies.x.resize(size);
+        bodies.y.resize(size);
+        bodies.velocityX.resize(size);
+        bodies.velocityY.resize(size);
+        bodies.accelerationX.resize(size);
+        bodies.accelerationY.resize(size);
+        bodies.mass.resize(size);
+        bodies.gravityScale.resize(size);
+        bodies.enabled.resize(size);
+        bodies.continuous.resize(size);
+        bodies.restitution.resize(size);
+        bodies.friction.resize(size);
+        bodies.awake.resize(size);
+        bodies.sleepTime.resize(size);
+        bodies.fixedPosition.resize(size);
+        bodies.fixedVelocity.resize(size);
+    }
+
+    constexpr unsigned int MAX_TICKS_PER_FRAME = 8; // more are left for the next frames, so a slow frame can't stall the game
+
+    bool deterministic = false;
+    double tickMilliseconds = 1000.0 / 60.0;
+    double tickAccumulator = 0.0;
+    unsigned long long tickCount = 0;
+    unsigned long long stateChecksum = 0;
+
+    // the fixed value is the real one, it's only replaced if game code set a different float
+    inline void syncFixed(float value, Fixed& fixed) {
+        if (fixed.toFloat() != value) fixed = Fixed::fromFloat(value);
+    }
+
+    void fixedStep() {
+        Fixed dt = Fixed::fromFloat((float)tickMilliseconds);
+        Fixed fixedGravity = Fixed::fromFloat(gravity);
+
+        for (unsigned int i = 0; i < bodies.owners.size(); i++) {
+            if (bodies.owners[i] == nullptr || bodies.enabled[i] == 0.0f) continue;
+
+            Entity* owner = bodies.owners[i];
+            FixedVec2& position = bodies.fixedPosition[i];
+            FixedVec2& velocity = bodies.fixedVelocity[i];
+
+            syncFixed(owner->getX(), position.x);
+            syncFixed(owner->getY(), position.y);
+            syncFixed(bodies.velocityX[i], velocity.x);
+            syncFixed(bodies.velocityY[i], velocity.y);
+
+            FixedVec2 acceleration = {
+                Fixed::fromFloat(bodies.accelerationX[i]),
+                Fixed::fromFloat(bodies.accelerationY[i]) + fixedGravity * Fixed::fromFloat(bodies.gravityScale[i])
+            };
+
+            velocity += acceleration * dt;
+            position += velocity * dt;
+
+            bodies.velocityX[i] = velocity.x.toFloat();
+            bodies.velocityY[i] = velocity.y.toFloat();
+
+            owner->setX(position.x.toFloat());
+            owner->setY(position.y.toFloat());
+        }
+    }
+
+    // FNV-1a over the simulated state in ID order: entities with their bodies, hitboxes and contacts.
+    // Other objects like the HUD are moved by the frame, not by the ticks, so they are left out
+    unsigned long long computeChecksum() {
+        unsigned long long hash = 14695981039346656037ULL;
+
+        auto mix = [&](uint32_t value) {
+            for (int byte = 0; byte < 4; byte++) {
+                hash ^= (value >> (byte * 8)) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+        };
+
+        auto mixFloat = [&](float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            mix(bits);
+        };
+
+        mix((uint32_t)tickCount);
+
+        for (auto& [id, object] : engine::getObjects()) {
+            if (object == nullptr) continue;
+            if (object->getType() != ObjectType::ENTITY && object->getType() != ObjectType::HITBOX) continue;
+
+            mix(id);
+            mixFloat(object->getX());
+            mixFloat(object->getY());
+            mixFloat(object->getAngle());
+
+            if (object->getType() != ObjectType::ENTITY) continue;
+
+            unsigned int index = static_cast<const Entity&>(*object).getBodyIndex();
+            if (bodies.enabled[index] == 0.0f) continue;
+
+            mix((uint32_t)bodies.fixedPosition[index].x.raw);
+            mix((uint32_t)bodies.fixedPosition[index].y.raw);
+            mix((uint32_t)bodies.fixedVelocity[index].x.raw);
+            mix((uint32_t)bodies.fixedVelocity[index].y.raw);
+        }
+
+        // contacts decide which callbacks run, so two runs with the same positions but other contacts still differ
+        for (const ContactManifold& contact : collision::getContacts()) {
+            mix(contact.idA);
+            mix(contact.idB);
+            mixFloat(contact.normalX);
+            mixFloat(contact.normalY);
+            mixFloat(contact.depth);
+        }
+
+        return hash;
+    }
+
+    // gap kept between a swept box and what it hit, so the next sweep doesn't start inside it
+    constexpr float SWEEP_SKIN = 0.01f;
+
+    physics::Broadphase broadphaseType = physics::Broadphase::TREE;
+
+    struct CollisionFilter {
+        unsigned int owner; // the parent of a hitbox, the object itself otherwise
+        unsigned int layer;
+        unsigned int mask;
+    };
+
+    CollisionFilter makeFilter(unsigned int id, const Object& object) {
+        unsigned int owner = object.getType() == ObjectType::HITBOX ? static_cast<const Hitbox&>(object).getParentID() : id;
+        return {owner, object.getCollisionLayer(), object.getCollisionMask()};
+    }
+
+    // parts of the same object never collide, and both layers have to be in the other's mask
+    inline bool acceptsPair(const CollisionFilter& a, const CollisionFilter& b) {
+        return a.owner != b.owner && (a.layer & b.mask) != 0 && (b.layer & a.mask) != 0;
+    }
+
+    SpatialHash broadphase;
+    std::unordered_map<unsigned int, CollisionFilter> gridFilters;
+    std::vector<std::pair<unsigned int, unsigned int>> gridPairs;
+    std::vector<std::pair<unsigned int, unsigned int>> candidatePairs;
+
+    struct TreeProxy {
+        int proxy;
+        bool isStatic;
+        AABB box; // tight bounds, the trees only know the fat ones
+        CollisionFilter filter;
+        unsigned long long frame; // last update that saw the object
+    };
+
+    AABBTree staticTree;
+    AABBTree dynamicTree;
+    std::unordered_map<unsigned int, TreeProxy> treeProxies;
+    unsigned long long treeFrame = 0;
+
+    std::vector<std::pair<int, int>> proxyPairs;
+
+    void updateTrees() {
+        treeFrame++;
+
+        for (auto& [id, object] : engine::getObjects()) {
+            if (object == nullptr || !object->isCollidable()) continue;
+
+            AABB box = object->getAABB();
+            bool isStatic = object->isStatic();
+            CollisionFilter filter = makeFilter(id, *object);
+
+            auto it = treeProxies.find(id);
+
+            if (it == treeProxies.end()) {
+                AABBTree& tree = isStatic ? staticTree : dynamicTree;
+                treeProxies[id] = {tree.insert(id, box), isStatic, box, filter, treeFrame};
+                continue;
+            }
+
+            TreeProxy& proxy = it->second;
+
+            if (proxy.isStatic != isStatic) {
+                (proxy.isStatic ? staticTree : dynamicTree).remove(proxy.proxy);
+                proxy.proxy = (isStatic ? staticTree : dynamicTree).insert(id, box);
+                proxy.isStatic = isStatic;
+            }
+            else (isStatic ? staticTree : dynamicTree).move(proxy.proxy, box);
+
+            proxy.box = box;
+            proxy.filter = filter;
+            proxy.frame = treeFrame;
+        }
+
+        // objects that were deleted or stopped being collidable
+        for (auto it = treeProxies.begin(); it != treeProxies.end();) {
+            if (it->second.frame == treeFrame) { ++it; continue; }
+
+            (it->second.isStatic ? staticTree : dynamicTree).remove(it->second.proxy);
+            it = treeProxies.erase(it);
+        }
+
+        candidatePairs.clear();
+
+        // moving against moving, then moving against static, static pairs are never tested
+        proxyPairs.clear();
+        dynamicTree.findPairs(proxyPairs);
+        unsigned int dynamicPairCount = proxyPairs.size();
+        dynamicTree.findPairs(staticTree, proxyPairs);
+
+        for (unsigned int i = 0; i < proxyPairs.size(); i++) {
+            unsigned int idA = dynamicTree.getId(proxyPairs[i].first);
+            unsigned int idB = (i < dynamicPairCount ? dynamicTree : staticTree).getId(proxyPairs[i].second);
+
+            const TreeProxy& proxyA = treeProxies[idA];
+            const TreeProxy& proxyB = treeProxies[idB];
+
+            // the trees report fat boxes, keep only pairs whose real bounds overlap
+            if (!proxyA.box.overlaps(proxyB.box)) continue;
+            if (!acceptsPair(proxyA.filter, proxyB.filter)) continue;
+
+            candidatePairs.push_back(idA < idB ? std::make_pair(idA, idB) : std::make_pair(idB, idA));
+        }
+    }
+
+    // calls visit for every collidable object whose bounds may cross the segment, visit gets the current limit
+    // and returns the new one, objects beyond the limit are skipped and a limit of 0 stops the walk
+    void walkSegment(float x1, float y1, float x2, float y2, const std::function<float(unsigned int, float)>& visit) {
+        float limit = 1.0f;
+
+        if (broadphaseType == physics::Broadphase::TREE) {
+            for (const AABBTree* tree : {&dynamicTree, &staticTree}) {
+                if (limit == 0.0f) return;
+
+                // the limit carries over from the other tree, so it is never above the fraction of this tree
+                tree->raycast(x1, y1, x2, y2, [&](int proxy, float) {
+                    limit = std::min(limit, visit(tree->getId(proxy), limit));
+                    return limit;
+                });
+            }
+
+            return;
+        }
+
+        AABB bounds = {std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2)};
+
+        for (unsigned int id : physics::queryAABB(bounds)) {
+            limit = std::min(limit, visit(id, limit));
+            if (limit == 0.0f) return;
+        }
+    }
+
+    // tests the shape of one object, only reads, so rays can be cast from many threads
+    bool raycastObject(unsigned int id, float x1, float y1, float x2, float y2, unsigned int mask, RaycastHit& hit) {
+        const auto& objects = engine::getObjects();
+
+        auto it = objects.find(id);
+        if (it == objects.end() || it->second == nullptr) return false;
+        if ((it->second->getCollisionLayer() & mask) == 0) return false;
+
+        ConvexShape shape;
+        collision::makeShape(*it->second, shape);
+
+        float fraction, normalX, normalY;
+        if (!collision::raycast(shape, x1, y1, x2, y2, fraction, normalX, normalY)) return false;
+
+        hit = {true, id, fraction, x1 + (x2 - x1) * fraction, y1 + (y2 - y1) * fraction, normalX, normalY};
+        return true;
+    }
+
+    void clearTrees() {
+        staticTree.clear();
+        dynamicTree.clear();
+        treeProxies.clear();
+    }
 }
 
 bool physics::isColliding(unsigned int objectID1, unsigned int objectID2) {
+    ConvexShape shape1, shape2;
+    collision::makeShape(*engine::getObject(objectID1), shape1);
+    collision::makeShape(*engine::getObject(objectID2), shape2);
+
+    ContactManifold manifold;
+    return collision::collide(shape1, shape2, manifold);
+}
+
+void physics::setBroadphase(Broadphase type) {
+    if (type == broadphaseType) return;
+
+    broadphaseType = type;
+
+    broadphase.clear();
+    gridFilters.clear();
+    clearTrees();
+    candidatePairs.clear();
+}
 
-    cast<Object> object1 = engine::getObject(objectID1);
-    cast<Object> object2 = engine::getObject(objectID2);
+physics::Broadphase physics::getBroadphase() { return broadphaseType; }
 
-    float x1 = object1->getX();
-    float y1 = object1->getY();
-    float width1 = object1->getWidth();
-    float height1 = object1->getHeight();
+void physics::updateBroadphase() {
+    if (broadphaseType == Broadphase::TREE) {
+        updateTrees();
+        return;
+    }
 
-    float x2 = object2->getX();
-    float y2 = object2->getY();
-    float width2 = object2->getWidth();
-    float height2 = object2->getHeight();
+    broadphase.clear();
+    gridFilters.clear();
 
-    if (x1 < x2 + width2 &&
-        x1 + width1 > x2 &&
-        y1 < y2 + height2 &&
-        y1 + height1 > y2) return true;
+    for (auto& [id, object] : engine::getObjects()) {
+        if (object == nullptr || !object->isCollidable()) continue;
 
-    return false;
+        broadphase.insert(id, object->getAABB());
+        gridFilters[id] = makeFilter(id, *object);
+    }
+
+    broadphase.build();
+    broadphase.findPairs(gridPairs);
+
+    candidatePairs.clear();
+
+    for (auto& pair : gridPairs) {
+        if (acceptsPair(gridFilters[pair.first], gridFilters[pair.second])) candidatePairs.push_back(pair);
+    }
+}
+
+const std::vector<std::pair<unsigned int, unsigned int>>& physics::getCandidatePairs() {
+    return candidatePairs;
+}
+
+std::vector<unsigned int> physics::queryAABB(const AABB& area) {
+    std::vector<unsigned int> result;
+
+    if (broadphaseType == Broadphase::GRID) {
+        broadphase.query(area, result);
+        return result;
+    }
+
+    auto collect = [&](const AABBTree& tree) {
+        tree.query(area, [&](int proxy) {
+            unsigned int id = tree.getId(proxy);
+            if (treeProxies.at(id).box.overlaps(area)) result.push_back(id);
+
+            return true;
+        });
+    };
+
+    collect(dynamicTree);
+    collect(staticTree);
+
+    return result;
 }
 
+void physics::setCellSize(float cellSize) {
+    broadphase.setCellSize(cellSize);
+}
+
+SweepHit physics::sweepAgainst(const AABB& moving, float dx, float dy, const AABB& target) {
+    SweepHit miss = {false, 1.0f, 0.0f, 0.0f, 0};
+
+    // times the moving box enters and leaves the target on each axis
+    float entryX, exitX, entryY, exitY;
+
+    if (dx == 0.0f) {
+        if (moving.maxX <= target.minX || moving.minX >= target.maxX) return miss;
+        entryX = -INFINITY;
+        exitX = INFINITY;
+    }
+    else {
+        entryX = (dx > 0.0f ? target.minX - moving.maxX : target.maxX - moving.minX) / dx;
+        exitX = (dx > 0.0f ? target.maxX - moving.minX : target.minX - moving.maxX) / dx;
+    }
+
+    if (dy == 0.0f) {
+        if (moving.maxY <= target.minY || moving.minY >= target.maxY) return miss;
+        entryY = -INFINITY;
+        exitY = INFINITY;
+    }
+    else {
+        entryY = (dy > 0.0f ? target.minY - moving.maxY : target.maxY - moving.minY) / dy;
+        exitY = (dy > 0.0f ? target.maxY - moving.minY : target.minY - moving.maxY) / dy;
+    }
+
+    float entry = std::max(entryX, entryY);
+    float exit = std::min(exitX, exitY);
+
+    // overlapping at the start, moving away, or not reached this step
+    if (entry < 0.0f || entry >= exit || entry > 1.0f) return miss;
+
+    SweepHit hit = {true, entry, 0.0f, 0.0f, 0};
+
+    if (entryX > entryY) hit.normalX = dx > 0.0f ? -1.0f : 1.0f;
+    else hit.normalY = dy > 0.0f ? -1.0f : 1.0f;
+
+    return hit;
+}
+
+SweepHit physics::sweepAABB(const AABB& box, float dx, float dy, unsigned int ignoreID, unsigned int mask, unsigned int layer) {
+    SweepHit first = {false, 1.0f, 0.0f, 0.0f, 0};
+
+    if (dx == 0.0f && dy == 0.0f) return first;
+
+    AABB moved = {box.minX + dx, box.minY + dy, box.maxX + dx, box.maxY + dy};
+
+    for (unsigned int id : queryAABB(AABB::combine(box, moved))) {
+        if (id == ignoreID) continue;
+
+        cast<Object> object = engine::getObject(id);
+        if (object == nullptr) continue;
+
+        // same rule as the contact pairs, both layers have to be in the other's mask
+        if ((object->getCollisionLayer() & mask) == 0 || (object->getCollisionMask() & layer) == 0) continue;
+        if (object->getType() == ObjectType::HITBOX && std::static_pointer_cast<Hitbox>(object)->getParentID() == ignoreID) continue;
+
+        SweepHit hit = sweepAgainst(box, dx, dy, object->getAABB());
+        if (!hit.hit || hit.time >= first.time) continue;
+
+        hit.id = id;
+        first = hit;
+    }
+
+    if (first.hit) {
+        float length = std::sqrt(dx * dx + dy * dy);
+        first.time = std::max(0.0f, first.time - SWEEP_SKIN / length);
+    }
+
+    return first;
+}
+
+SweepHit physics::shapeCast(unsigned int objectID, float dx, float dy, unsigned int mask) {
+    cast<Object> object = engine::getObject(objectID);
+    return sweepAABB(object->getAABB(), dx, dy, objectID, mask, object->getCollisionLayer());
+}
+
+RaycastHit physics::raycast(float x1, float y1, float x2, float y2, unsigned int mask) {
+    RaycastHit closest = {false, 0, 1.0f, x2, y2, 0.0f, 0.0f};
+
+    // every hit shortens the ray, so farther objects are never tested
+    walkSegment(x1, y1, x2, y2, [&](unsigned int id, float limit) {
+        RaycastHit hit;
+        if (!raycastObject(id, x1, y1, x2, y2, mask, hit) || hit.fraction >= limit) return limit;
+
+        closest = hit;
+        return hit.fraction;
+    });
+
+    return closest;
+}
+
+std::vector<RaycastHit> physics::raycastAll(float x1, float y1, float x2, float y2, unsigned int mask) {
+    std::vector<RaycastHit> hits;
+
+    walkSegment(x1, y1, x2, y2, [&](unsigned int id, float limit) {
+        RaycastHit hit;
+        if (raycastObject(id, x1, y1, x2, y2, mask, hit)) hits.push_back(hit);
+
+        return limit;
+    });
+
+    std::sort(hits.begin(), hits.end(), [](const RaycastHit& a, const RaycastHit& b) { return a.fraction < b.fraction; });
+
+    return hits;
+}
+
+void physics::raycastBatch(const std::vector<Ray>& rays, std::vector<RaycastHit>& hits, unsigned int mask) {
+    hits.resize(rays.size());
+
+    // the broadphase and the objects are only read while the rays are cast
+    jobs::parallelFor(rays.size(), 64, [&](unsigned int begin, unsigned int end, unsigned int worker) {
+        for (unsigned int i = begin; i < end; i++) hits[i] = raycast(rays[i].x1, rays[i].y1, rays[i].x2, rays[i].y2, mask);
+    });
+}
+
+std::vector<unsigned int> physics::overlapCircle(float x, float y, float radius, unsigned int mask) {
+    std::vector<unsigned int> result;
+
+    for (unsigned int id : queryAABB({x - radius, y - radius, x + radius, y + radius})) {
+        cast<Object> object = engine::getObject(id);
+        if ((object->getCollisionLayer() & mask) == 0) continue;
+
+        ConvexShape shape;
+        collision::makeShape(*object, shape);
+
+        if (collision::overlapsCircle(shape, x, y, radius)) result.push_back(id);
+    }
+
+    return result;
+}
+
+void physics::setTreeMargin(float margin) {
+    staticTree.setMargin(margin);
+    dynamicTree.setMargin(margin);
+}
+
+unsigned int physics::addBody(Entity* owner) {
+    unsigned int index;
+
+    if (!freeBodies.empty()) {
+        index = freeBodies.back();
+        freeBodies.pop_back();
+    }
+    else {
+        index = bodies.owners.size();
+        resizeBodies(index + 1);
+    }
+
+    bodies.owners[index] = owner;
+    bodies.x[index] = 0.0f;
+    bodies.y[index] = 0.0f;
+    bodies.velocityX[index] = 0.0f;
+    bodies.velocityY[index] = 0.0f;
+    bodies.accelerationX[index] = 0.0f;
+    bodies.accelerationY[index] = 0.0f;
+    bodies.mass[index] = 1.0f;
+    bodies.gravityScale[index] = 0.0f;
+    bodies.enabled[index] = 0.0f;
+    bodies.continuous[index] = 0;
+    bodies.restitution[index] = 0.0f;
+    bodies.friction[index] = 0.5f;
+    bodies.awake[index] = 1.0f;
+    bodies.sleepTime[index] = 0.0f;
+    bodies.fixedPosition[index] = {};
+    bodies.fixedVelocity[index] = {};
+
+    return index;
+}
+
+void physics::removeBody(unsigned int index) {
+    bodies.owners[index] = nullptr;
+    bodies.enabled[index] = 0.0f;
+    freeBodies.push_back(index);
+}
+
+PhysicsBodies& physics::getBodies() { return bodies; }
+
+void physics::step(double elapsedTime) {
+    unsigned int count = bodies.owners.size();
+    unsigned int moved = 0;
+
+    // sleeping bodies are gathered too, the solver can wake them before they move
+    for (unsigned int i = 0; i < count; i++) {
+        if (bodies.enabled[i] == 0.0f) continue;
+
+        float x = bodies.owners[i]->getX();
+        float y = bodies.owners[i]->getY();
+
+        // moved by game code or an attachment while asleep, setX and setY don't wake on their own
+        if (bodies.awake[i] == 0.0f && (x != bodies.x[i] || y != bodies.y[i])) {
+            bodies.awake[i] = 1.0f;
+            bodies.sleepTime[i] = 0.0f;
+        }
+
+        bodies.x[i] = x;
+        bodies.y[i] = y;
+    }
+
+    float dt = (float)elapsedTime;
+    float gravityStep = gravity * dt;
+
+    {
+        float* __restrict velocityX = bodies.velocityX.data();
+        float* __restrict velocityY = bodies.velocityY.data();
+        const float* __restrict accelerationX = bodies.accelerationX.data();
+        const float* __restrict accelerationY = bodies.accelerationY.data();
+        const float* __restrict gravityScale = bodies.gravityScale.data();
+        const float* __restrict enabled = bodies.enabled.data();
+        const float* __restrict awake = bodies.awake.data();
+
+        // disabled and sleeping bodies are multiplied by 0 instead of skipped, so the loop has no branches
+        for (unsigned int i = 0; i < count; i++) {
+            float active = enabled[i] * awake[i];
+
+            velocityX[i] += (accelerationX[i] * dt) * active;
+            velocityY[i] += (accelerationY[i] * dt + gravityStep * gravityScale[i]) * active;
+        }
+    }
+
+    // contacts change the velocities before they move anything
+    solver::solve(bodies, collision::getContacts(), dt);
+
+    {
+        float* __restrict x = bodies.x.data();
+        float* __restrict y = bodies.y.data();
+        const float* __restrict velocityX = bodies.velocityX.data();
+        const float* __restrict velocityY = bodies.velocityY.data();
+        const float* __restrict enabled = bodies.enabled.data();
+        const float* __restrict awake = bodies.awake.data();
+
+        for (unsigned int i = 0; i < count; i++) {
+            float active = enabled[i] * awake[i];
+
+            x[i] += velocityX[i] * dt * active;
+            y[i] += velocityY[i] * dt * active;
+        }
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (bodies.enabled[i] == 0.0f || bodies.awake[i] == 0.0f) continue;
+
+        Entity* owner = bodies.owners[i];
+
+        if (bodies.continuous[i]) {
+            float dx = bodies.x[i] - owner->getX();
+            float dy = bodies.y[i] - owner->getY();
+
+            SweepHit hit = sweepAABB(owner->getAABB(), dx, dy, owner->getID(), owner->getCollisionMask(), owner->getCollisionLayer());
+
+            if (hit.hit) {
+                // stop at the contact and drop the velocity into the surface
+                bodies.x[i] = owner->getX() + dx * hit.time;
+                bodies.y[i] = owner->getY() + dy * hit.time;
+
+                if (hit.normalX != 0.0f) bodies.velocityX[i] = 0.0f;
+                if (hit.normalY != 0.0f) bodies.velocityY[i] = 0.0f;
+            }
+        }
+
+        owner->setX(bodies.x[i]);
+        owner->setY(bodies.y[i]);
+        moved++;
+    }
+
+    lastStepCount = moved;
+}
+
+unsigned int physics::getLastStepCount() { return lastStepCount; }
+
+void physics::setDeterministic(bool enabled, double tickLength) {
+    deterministic = enabled;
+    tickMilliseconds = tickLength > 0.0 ? tickLength : 1000.0 / 60.0;
+
+    tickAccumulator = 0.0;
+    tickCount = 0;
+    stateChecksum = 0;
+}
+
+bool physics::isDeterministic() { return deterministic; }
+
+void physics::advance(double elapsedTime) {
+    if (!deterministic) {
+        step(elapsedTime);
+        return;
+    }
+
+    tickAccumulator += elapsedTime;
+
+    for (unsigned int ticks = 0; ticks < MAX_TICKS_PER_FRAME && tickAccumulator >= tickMilliseconds; ticks++) {
+        tickAccumulator -= tickMilliseconds;
+
+        // the object map is ordered by ID, so every run updates the entities in the same order
+        for (auto& [id, object] : engine::getObjects()) {
+            if (object != nullptr && object->getType() == ObjectType::ENTITY) static_cast<Entity&>(*object).fixedUpdate(tickMilliseconds);
+        }
+
+        fixedStep();
+
+        // contacts and their callbacks belong to the tick, not to the frame, so every run sees the same ones
+        engine::syncAttachments();
+        updateBroadphase();
+        collision::update();
+
+        tickCount++;
+        stateChecksum = computeChecksum();
+    }
+}
+
+unsigned long long physics::getTickCount() { return tickCount; }
+unsigned long long physics::getStateChecksum() { return stateChecksum; }
+
 void physics::move(unsigned int entityID, double elapsedTime) {
     cast<Entity> entity = std::dynamic_pointer_cast<Entity>(engine::getObject(entityID));
 
@@ -42,12 +700,27 @@ void physics::move(unsigned int entityID, double elapsedTime) {
 void physics::moveWithAngle(unsigned int entityID, double elapsedTime, float baseSpeed) {
     cast<Entity> entity = std::dynamic_pointer_cast<Entity>(engine::getObject(entityID));
 
-    entity->setVelocityX(baseSpeed * cos(entity->getAngle()));
-    entity->setVelocityY(baseSpeed * sin(entity->getAngle()));
+    // angles are in degrees and turn counterclockwise on screen, where y grows downwards
+    float radians = entity->getAngle() * fastmath::DEG_TO_RAD;
+
+    entity->setVelocityX(baseSpeed * std::cos(radians));
+    entity->setVelocityY(-baseSpeed * std::sin(radians));
 
     move(entityID, elapsedTime);
 }
 
+void physics::lookAt(unsigned int entityID, unsigned int targetID) {
+    cast<Entity> entity = std::dynamic_pointer_cast<Entity>(engine::getObject(entityID));
+    cast<Object> target = engine::getObject(targetID);
+
+    float dx = (target->getX() + target->getWidth() / 2.0f) - (entity->getX() + entity->getWidth() / 2.0f);
+    float dy = (target->getY() + target->getHeight() / 2.0f) - (entity->getY() + entity->getHeight() / 2.0f);
+
+    if (dx == 0.0f && dy == 0.0f) return;
+
+    entity->setRotation(std::atan2(-dy, dx) / fastmath::DEG_TO_RAD);
+}
+
 void physics::accelerate(unsigned int entityID, double elapsedTime) {
     cast<Entity> entity = std::dynamic_pointer_cast<Entity>(engine::getObject(entityID));
 
@@ -56,4 +729,10 @@ void physics::accelerate(unsigned int entityID, double elapsedTime) {
 }
 
 void physics::setGravity(float newGravity) { gravity = newGravity; }
+
+void physics::applyGravity(unsigned int entityID) {
+    cast<Entity> entity = std::dynamic_pointer_cast<Entity>(engine::getObject(entityID));
+    entity->setGravityScale(1.0f);
+}
+
 float physics::getGravity() { return gravity; }
@@ -1,17 +1,269 @@
 #pragma once
 
+#include "../util/AABB.h"
+#include "../util/Fixed.h"
+
+#include <vector>
+#include <utility>
+
+#define ALL_COLLISION_LAYERS 0xFFFFFFFF
+
+class Entity;
+
+/**
+ * @brief Motion of every entity, one array per field so the physics step runs over them in one vectorized pass.
+ * Indexed by the body index of the entity, free slots have no owner.
+ */
+struct PhysicsBodies {
+    std::vector<Entity*> owners;
+
+    std::vector<float> x, y; // gathered from the owners at the start of a step
+    std::vector<float> velocityX, velocityY;
+    std::vector<float> accelerationX, accelerationY;
+    std::vector<float> mass;
+    std::vector<float> gravityScale; // 0 until applyGravity is called
+    std::vector<float> enabled; // 1 if the body is moved by step, 0 otherwise
+    std::vector<unsigned char> continuous; // 1 if the step sweeps the body instead of teleporting it
+
+    std::vector<float> restitution; // 0 stops on impact, 1 bounces back at full speed
+    std::vector<float> friction;
+    std::vector<float> awake; // 0 while the body sleeps, sleeping bodies are skipped like disabled ones
+    std::vector<float> sleepTime; // milliseconds the body has been almost still
+
+    std::vector<FixedVec2> fixedPosition, fixedVelocity; // the real state in deterministic mode
+};
+
+/**
+ * @brief The first contact of a moving box.
+ */
+struct SweepHit {
+    bool hit;
+    float time; /**< fraction of the movement before the contact, 0 to 1. */
+    float normalX, normalY; /**< the side of the other box that was hit, pointing away from it. */
+    unsigned int id; /**< the object that was hit. */
+};
+
+/**
+ * @brief Where a ray hit an object.
+ */
+struct RaycastHit {
+    bool hit;
+    unsigned int id; /**< the object that was hit. */
+    float fraction; /**< 0 at the start of the ray, 1 at its end. */
+    float x, y; /**< the point that was hit. */
+    float normalX, normalY; /**< the normal of the surface that was hit. */
+};
+
+struct Ray {
+    float x1, y1;
+    float x2, y2;
+};
+
 namespace physics {
+    /**
+     * @brief How the broadphase finds candidate pairs.
+     * GRID rebuilds a uniform grid every frame, good when objects have similar sizes.
+     * TREE keeps dynamic bounding volume trees, one for static and one for moving objects,
+     * good when object sizes vary a lot. Static objects are never tested against each other.
+     */
+    enum class Broadphase {
+        GRID,
+        TREE
+    };
+
+    /**
+     * @brief Checks if two objects overlap, taking their rotation and hitbox polygons into account.
+     */
     bool isColliding(unsigned int objectID1, unsigned int objectID2);
 
+    /**
+     * @brief Selects the broadphase. The tree is used by default.
+     */
+    void setBroadphase(Broadphase type);
+    Broadphase getBroadphase();
+
+    /**
+     * @brief Updates the broadphase from the bounds of all collidable objects.
+     * WARNING: This function is called automatically per frame by the engine.
+     */
+    void updateBroadphase();
+
+    /**
+     * @brief Gets the pairs of collidable objects whose bounding boxes overlap, found by the last broadphase update.
+     * Pairs whose collision layers and masks don't match, and hitboxes of the same parent, are left out.
+     * Each pair is listed once, smaller ID first.
+     */
+    const std::vector<std::pair<unsigned int, unsigned int>>& getCandidatePairs();
+
+    /**
+     * @brief Finds the collidable objects whose bounding boxes overlap an area.
+     *
+     * @param area The area in world coordinates.
+     * @return The IDs of the objects.
+     */
+    std::vector<unsigned int> queryAABB(const AABB& area);
+
+    /**
+     * @brief Sets the cell size of the broadphase grid. Works best around the size of a typical object.
+     */
+    void setCellSize(float cellSize);
+
+    /**
+     * @brief Finds the first collidable object a box hits while it moves, so fast objects can't pass through thin ones.
+     * Objects the box already overlaps at the start are ignored.
+     *
+     * @param box The box at the start of the movement.
+     * @param dx The movement on the x axis.
+     * @param dy The movement on the y axis.
+     * @param ignoreID An object that can't be hit, with its hitboxes. Usually the object that moves.
+     * @param mask Only objects on these collision layers can be hit.
+     * @param layer The collision layers of the box, only objects whose mask contains one of them can be hit.
+     * @return The first contact, hit is false if the box can move freely.
+     */
+    SweepHit sweepAABB(const AABB& box, float dx, float dy, unsigned int ignoreID, unsigned int mask = ALL_COLLISION_LAYERS, unsigned int layer = ALL_COLLISION_LAYERS);
+
+    /**
+     * @brief Moves the bounds of an object through the world and finds the first thing they hit.
+     * The object and its hitboxes are ignored.
+     *
+     * @param objectID The object to cast.
+     * @param dx The movement on the x axis.
+     * @param dy The movement on the y axis.
+     * @param mask Only objects on these collision layers can be hit. Objects whose mask doesn't contain the layer
+     * of the cast object are never hit.
+     */
+    SweepHit shapeCast(unsigned int objectID, float dx, float dy, unsigned int mask = ALL_COLLISION_LAYERS);
+
+    /**
+     * @brief Finds the first collidable object on the segment from (x1, y1) to (x2, y2).
+     * Uses the shapes of the objects, rotation and hitbox polygons included.
+     *
+     * @param mask Only objects on these collision layers can be hit.
+     * @return The closest hit, hit is false if the segment is free.
+     */
+    RaycastHit raycast(float x1, float y1, float x2, float y2, unsigned int mask = ALL_COLLISION_LAYERS);
+
+    /**
+     * @brief Finds every collidable object on the segment from (x1, y1) to (x2, y2).
+     *
+     * @param mask Only objects on these collision layers can be hit.
+     * @return The hits, closest first.
+     */
+    std::vector<RaycastHit> raycastAll(float x1, float y1, float x2, float y2, unsigned int mask = ALL_COLLISION_LAYERS);
+
+    /**
+     * @brief Casts many rays on all workers.
+     *
+     * @param rays The rays to cast.
+     * @param hits Filled with the closest hit of every ray, in the same order.
+     * @param mask Only objects on these collision layers can be hit.
+     */
+    void raycastBatch(const std::vector<Ray>& rays, std::vector<RaycastHit>& hits, unsigned int mask = ALL_COLLISION_LAYERS);
+
+    /**
+     * @brief Finds the collidable objects whose shapes overlap a circle.
+     *
+     * @param mask Only objects on these collision layers are returned.
+     * @return The IDs of the objects.
+     */
+    std::vector<unsigned int> overlapCircle(float x, float y, float radius, unsigned int mask = ALL_COLLISION_LAYERS);
+
+    /**
+     * @brief Calculates when a moving box first touches a still one.
+     *
+     * @return The hit with the time of impact and the normal, id is not set.
+     */
+    SweepHit sweepAgainst(const AABB& moving, float dx, float dy, const AABB& target);
+
+    /**
+     * @brief Sets how much the boxes in the broadphase trees are enlarged. Objects moving less than this
+     * don't change the trees. Only affects boxes inserted after the call.
+     */
+    void setTreeMargin(float margin);
+
+    /**
+     * @brief Creates the motion state of a new entity.
+     *
+     * @return The body index, stays the same until the body is removed.
+     */
+    unsigned int addBody(Entity* owner);
+
+    /**
+     * @brief Frees the body, its index can be given to a new entity.
+     */
+    void removeBody(unsigned int index);
+
+    PhysicsBodies& getBodies();
+
+    /**
+     * @brief Integrates acceleration and gravity, resolves the contacts of the last collision update,
+     * then integrates the positions of every awake physics enabled entity.
+     * WARNING: This function is called automatically per frame by the engine.
+     *
+     * @param elapsedTime The time since the last step, in the same unit as the velocities.
+     */
+    void step(double elapsedTime);
+
+    /**
+     * @brief Gets how many entities were moved by the last step.
+     */
+    unsigned int getLastStepCount();
+
+    /**
+     * @brief Turns the deterministic mode on or off. In deterministic mode the simulation runs in fixed ticks
+     * instead of once per frame: every tick calls fixedUpdate on all entities in ID order, then integrates
+     * the physics enabled entities with Q16.16 fixed point math, so the same inputs give bit-exact results on every machine.
+     * Contacts are found and collision callbacks are called at the end of every tick, in the order of the object IDs.
+     * The contact solver and continuous collision don't run in this mode, fast entities have to be kept slow enough
+     * or short enough ticks used so they don't pass through thin objects. Positions and velocities must stay within +-32767, larger values saturate.
+     *
+     * @param enabled Whether the deterministic mode is on.
+     * @param tickMilliseconds The length of one tick.
+     */
+    void setDeterministic(bool enabled, double tickMilliseconds = 1000.0 / 60.0);
+    bool isDeterministic();
+
+    /**
+     * @brief Moves the simulation forward. Runs one step, or as many fixed ticks as the time covers in deterministic mode.
+     * WARNING: This function is called automatically per frame by the engine.
+     */
+    void advance(double elapsedTime);
+
+    /**
+     * @brief Gets how many fixed ticks have run since the deterministic mode was turned on.
+     */
+    unsigned long long getTickCount();
+
+    /**
+     * @brief Gets the checksum of the entities, their hitboxes and bodies and the contacts after the last fixed tick. Compare it between machines or runs
+     * to find the first tick where the simulations went apart.
+     */
+    unsigned long long getStateChecksum();
+
     void move(unsigned int entityID, double elapsedTime);
+
+    /**
+     * @brief Sets the velocity of the entity towards the direction it faces and moves it.
+     *
+     * @param baseSpeed The length of the new velocity.
+     */
     void moveWithAngle(unsigned int entityID, double elapsedTime, float baseSpeed);
 
+    /**
+     * @brief Rotates the entity so it faces the center of another object.
+     */
     void lookAt(unsigned int entityID, unsigned int targetID);
 
     void accelerate(unsigned int entityID, double elapsedTime);
 
+    /**
+     * @brief Sets the gravity, positive values pull down the screen.
+     */
     void setGravity(float newGravity);
 
+    /**
+     * @brief Makes the entity fall with the gravity in the physics step.
+     */
     void applyGravity(unsigned int entityID);
 
     float getGravity();
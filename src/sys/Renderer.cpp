@@ -0,0 +1,229 @@
+#include "Renderer.h"
+
+#include "Jobs.h"
+#include "DebugDraw.h"
+
+#include "../util/Object.h"
+#include "../util/renderer/Shaders.h"
+#include "../util/renderer/DefaultShaders.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#define MAX_BATCH_QUADS 4096
+
+namespace {
+    std::vector<CommandBuffer> commandBuffers; // one per worker
+    std::vector<const RenderCommand*> frameCommands; // merged and sorted
+
+    // batch shaders, vertices are pre-transformed so u_Model stays identity
+    std::unique_ptr<Shaders> screenShaders;
+    std::unique_ptr<Shaders> screenNoTextureShaders;
+    std::unique_ptr<Shaders> cameraShaders;
+    std::unique_ptr<Shaders> cameraNoTextureShaders;
+    std::unique_ptr<Shaders> screenArrayShaders;
+    std::unique_ptr<Shaders> cameraArrayShaders;
+
+    unsigned int VAO, VBO, EBO;
+
+    std::vector<Vertex> batchVertices;
+    bool batchAffectedByCamera;
+    unsigned int batchTexture;
+    bool batchTextureArray;
+
+    unsigned int drawCallCount;
+    unsigned int lastDrawCallCount;
+
+    bool backendEnabled = true;
+    bool isInitialized = false;
+
+    void flushBatch(const std::shared_ptr<Window>& window, const std::shared_ptr<Camera>& camera) {
+        if (batchVertices.empty()) return;
+
+        Shaders* shaders;
+        glm::mat4 model(1.0f);
+
+        if (batchAffectedByCamera) {
+            shaders = batchTexture == 0 ? cameraNoTextureShaders.get() : batchTextureArray ? cameraArrayShaders.get() : cameraShaders.get();
+
+            glm::mat4 view = camera->getViewMatrix();
+            glm::mat4 projection = camera->getProjectionMatrix();
+
+            shaders->activate();
+            shaders->setUniform("u_View", (float*)&view, SHADER_MAT4);
+            shaders->setUniform("u_Projection", (float*)&projection, SHADER_MAT4);
+        } else {
+            shaders = batchTexture == 0 ? screenNoTextureShaders.get() : batchTextureArray ? screenArrayShaders.get() : screenShaders.get();
+
+            glm::mat4 view = window->getProjectionMatrix();
+
+            shaders->activate();
+            shaders->setUniform("u_View", (float*)&view, SHADER_MAT4);
+        }
+
+        shaders->setUniform("u_Model", (float*)&model, SHADER_MAT4);
+
+        GLenum target = batchTextureArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(target, batchTexture);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+        // orphan the storage so the driver doesn't wait for the previous batch
+        glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_QUADS * 4 * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, batchVertices.size() * sizeof(Vertex), batchVertices.data());
+
+        glDrawElements(GL_TRIANGLES, (GLsizei)(batchVertices.size() / 4 * 6), GL_UNSIGNED_INT, 0);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindTexture(target, 0);
+
+        batchVertices.clear();
+        drawCallCount++;
+    }
+
+    void addOutline(const RenderCommand& command) {
+        glm::vec4 color = command.vertices[0].color;
+
+        debugdraw::setColor(color.r * 255.0f, color.g * 255.0f, color.b * 255.0f, color.a);
+        debugdraw::setAffectedByCamera(command.affectedByCamera);
+
+        for (int i = 0; i < 4; i++) {
+            const glm::vec3& from = command.vertices[i].position;
+            const glm::vec3& to = command.vertices[(i + 1) % 4].position;
+
+            debugdraw::line(from.x, from.y, to.x, to.y);
+        }
+    }
+
+    void submit(const std::shared_ptr<Window>& window, const std::shared_ptr<Camera>& camera) {
+        drawCallCount = 0;
+
+        for (const RenderCommand* command : frameCommands) {
+            switch (command->type) {
+                case CommandType::QUAD: {
+                    bool stateChanged = command->affectedByCamera != batchAffectedByCamera || command->texture != batchTexture ||
+                                        command->textureArray != batchTextureArray;
+
+                    if (stateChanged || batchVertices.size() >= MAX_BATCH_QUADS * 4) {
+                        flushBatch(window, camera);
+
+                        batchAffectedByCamera = command->affectedByCamera;
+                        batchTexture = command->texture;
+                        batchTextureArray = command->textureArray;
+                    }
+
+                    batchVertices.insert(batchVertices.end(), command->vertices, command->vertices + 4);
+                    break;
+                }
+
+                case CommandType::OUTLINE:
+                    addOutline(*command);
+                    break;
+
+                case CommandType::CUSTOM:
+                    flushBatch(window, camera);
+                    command->object->drawCustom(window, camera);
+                    drawCallCount++;
+                    break;
+            }
+        }
+
+        flushBatch(window, camera);
+
+        lastDrawCallCount = drawCallCount;
+    }
+}
+
+void renderer::init() {
+    if (isInitialized) return;
+
+    screenShaders = std::make_unique<Shaders>(defaultVertexShaderSource, defaultFragmentShaderSource);
+    screenNoTextureShaders = std::make_unique<Shaders>(defaultVertexShaderSource, defaultNoTextureFragmentShaderSource);
+    cameraShaders = std::make_unique<Shaders>(defaultCameraVertexShaderSource, defaultFragmentShaderSource);
+    cameraNoTextureShaders = std::make_unique<Shaders>(defaultCameraVertexShaderSource, defaultNoTextureFragmentShaderSource);
+    screenArrayShaders = std::make_unique<Shaders>(defaultArrayVertexShaderSource, defaultArrayFragmentShaderSource);
+    cameraArrayShaders = std::make_unique<Shaders>(defaultArrayCameraVertexShaderSource, defaultArrayFragmentShaderSource);
+
+    // every batch is made of quads, so the indices never change
+    std::vector<unsigned int> indices;
+    indices.reserve(MAX_BATCH_QUADS * 6);
+
+    for (unsigned int i = 0; i < MAX_BATCH_QUADS; i++) {
+        unsigned int first = i * 4;
+
+        indices.push_back(first);
+        indices.push_back(first + 1);
+        indices.push_back(first + 2);
+        indices.push_back(first + 2);
+        indices.push_back(first + 3);
+        indices.push_back(first);
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_QUADS * 4 * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, layer));
+    glEnableVertexAttribArray(3);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    batchVertices.reserve(MAX_BATCH_QUADS * 4);
+    batchAffectedByCamera = false;
+    batchTexture = 0;
+    batchTextureArray = false;
+    lastDrawCallCount = 0;
+
+    isInitialized = true;
+}
+
+void renderer::beginFrame() {
+    commandBuffers.resize(jobs::getWorkerCount());
+
+    for (auto& buffer : commandBuffers) buffer.clear();
+}
+
+CommandBuffer& renderer::getCommandBuffer(unsigned int workerIndex) {
+    return commandBuffers[workerIndex];
+}
+
+void renderer::endFrame(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) {
+    frameCommands.clear();
+
+    for (auto& buffer : commandBuffers) {
+        for (auto& command : buffer.getCommands()) frameCommands.push_back(&command);
+    }
+
+    // workers take ranges out of order, sort pointers back into painter order
+    std::sort(frameCommands.begin(), frameCommands.end(), [](const RenderCommand* a, const RenderCommand* b) {
+        return a->sortKey < b->sortKey;
+    });
+
+    if (backendEnabled && isInitialized) submit(window, camera);
+}
+
+const std::vector<const RenderCommand*>& renderer::getFrameCommands() { return frameCommands; }
+void renderer::setBackendEnabled(bool enabled) { backendEnabled = enabled; }
+unsigned int renderer::getLastDrawCallCount() { return lastDrawCallCount; }
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../util/renderer/RenderCommands.h"
+#include "../util/Window.h"
+#include "../classes/Camera.h"
+
+#include <vector>
+#include <memory>
+
+/**
+ * @brief Render command front end and GL back end.
+ * Objects record commands into one buffer per worker thread, the buffers are merged in painter order
+ * and replayed on the GL thread, where consecutive quads with the same texture are drawn in one call.
+ */
+namespace renderer {
+    /**
+     * @brief Creates the batch buffers and shaders of the back end.
+     */
+    void init();
+
+    /**
+     * @brief Clears the command buffers of all workers. Called before recording starts.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Gets the command buffer owned by a worker thread.
+     *
+     * @param workerIndex The index given by jobs::parallelFor.
+     */
+    CommandBuffer& getCommandBuffer(unsigned int workerIndex);
+
+    /**
+     * @brief Merges and sorts the recorded commands, then replays them if the back end is enabled.
+     *
+     * @param window The window to draw on.
+     * @param camera The camera to use for commands affected by camera.
+     */
+    void endFrame(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera);
+
+    /**
+     * @brief Gets the sorted commands of the last frame. Useful to inspect what would be drawn without a GL context.
+     */
+    const std::vector<const RenderCommand*>& getFrameCommands();
+
+    /**
+     * @brief Enables or disables the GL back end. When disabled commands are still recorded and sorted.
+     */
+    void setBackendEnabled(bool enabled);
+
+    /**
+     * @brief Gets how many draw calls the back end issued in the last frame.
+     */
+    unsigned int getLastDrawCallCount();
+}
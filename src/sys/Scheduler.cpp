@@ -0,0 +1,246 @@
+#include "Scheduler.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // 4 wheels of 64 slots with 1 ms ticks, the top wheel covers about 4.6 hours.
+    // A call waits in the wheel that fits its remaining time and moves to a finer wheel
+    // when the coarser slot it is in comes around, so every call moves at most 3 times.
+    constexpr unsigned int LEVELS = 4;
+    constexpr unsigned int SLOT_BITS = 6;
+    constexpr unsigned int SLOTS = 1u << SLOT_BITS;
+    constexpr unsigned int SLOT_MASK = SLOTS - 1;
+    constexpr unsigned long long WHEEL_RANGE = 1ull << (SLOT_BITS * LEVELS);
+
+    // handles are the node index + 1 in the low bits and the generation of the node in the high bits, like timer IDs
+    constexpr unsigned int INDEX_BITS = 20;
+    constexpr unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+    constexpr unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    struct ScheduledCall {
+        unsigned long long expiry; // tick of the next call
+        unsigned long long interval; // ticks, 0 for calls that happen once
+
+        std::function<void()> callback;
+
+        int previous, next; // neighbours in the slot list
+        int slot; // level * SLOTS + slot index, -1 while not in the wheel
+
+        unsigned int generation;
+        bool alive;
+    };
+
+    std::vector<ScheduledCall> calls;
+    std::vector<unsigned int> freeCalls;
+
+    int slotHeads[LEVELS * SLOTS];
+    bool slotsReady = false;
+
+    unsigned long long currentTick = 0;
+    double leftover = 0.0; // fraction of a tick carried to the next update
+
+    unsigned int activeCount = 0;
+
+    std::vector<std::pair<unsigned int, unsigned int>> dueCalls; // index and generation
+
+    void initSlots() {
+        std::fill(slotHeads, slotHeads + LEVELS * SLOTS, -1);
+        slotsReady = true;
+    }
+
+    void link(unsigned int index) {
+        ScheduledCall& call = calls[index];
+
+        // calls further than the wheel reaches wait in its last slot and are placed again when it comes around
+        unsigned long long expiry = std::max(call.expiry, currentTick);
+        unsigned long long delta = std::min(expiry - currentTick, WHEEL_RANGE - 1);
+        expiry = currentTick + delta;
+
+        unsigned int level = 0;
+        while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) level++;
+
+        int slot = level * SLOTS + ((expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+
+        call.slot = slot;
+        call.previous = -1;
+        call.next = slotHeads[slot];
+
+        if (call.next >= 0) calls[call.next].previous = index;
+        slotHeads[slot] = index;
+    }
+
+    void unlink(unsigned int index) {
+        ScheduledCall& call = calls[index];
+        if (call.slot < 0) return;
+
+        if (call.previous >= 0) calls[call.previous].next = call.next;
+        else slotHeads[call.slot] = call.next;
+
+        if (call.next >= 0) calls[call.next].previous = call.previous;
+
+        call.slot = -1;
+    }
+
+    // takes every call out of a slot, in list order
+    void takeSlot(int slot) {
+        for (int index = slotHeads[slot]; index >= 0; index = calls[index].next) {
+            dueCalls.push_back({(unsigned int)index, calls[index].generation});
+            calls[index].slot = -1;
+        }
+
+        slotHeads[slot] = -1;
+    }
+
+    // calls that reach their slot at this tick land in the finer slot of this tick, before it is taken
+    void cascade(unsigned int level) {
+        dueCalls.clear();
+        takeSlot(level * SLOTS + ((currentTick >> (SLOT_BITS * level)) & SLOT_MASK));
+
+        for (auto [index, generation] : dueCalls) link(index);
+    }
+
+    void release(unsigned int index) {
+        ScheduledCall& call = calls[index];
+
+        call.alive = false;
+        call.callback = nullptr;
+        call.generation = (call.generation + 1) & GENERATION_MASK;
+
+        freeCalls.push_back(index);
+        activeCount--;
+    }
+
+    ScheduledCall* findCall(unsigned int handle) {
+        unsigned int index = (handle & INDEX_MASK) - 1;
+        if (index >= calls.size()) return nullptr;
+
+        ScheduledCall& call = calls[index];
+        if (!call.alive || call.generation != (handle >> INDEX_BITS)) return nullptr;
+
+        return &call;
+    }
+
+    unsigned long long toTicks(double milliseconds) {
+        if (!(milliseconds > 0.0)) return 0;
+        return (unsigned long long)std::ceil(milliseconds);
+    }
+
+    unsigned int add(unsigned long long delay, unsigned long long interval, std::function<void()> callback) {
+        if (!slotsReady) initSlots();
+
+        unsigned int index;
+
+        if (!freeCalls.empty()) {
+            index = freeCalls.back();
+            freeCalls.pop_back();
+        } else {
+            index = calls.size();
+            calls.push_back({});
+            calls[index].generation = 0;
+        }
+
+        ScheduledCall& call = calls[index];
+        call.expiry = currentTick + std::max(delay, 1ull);
+        call.interval = interval;
+        call.callback = std::move(callback);
+        call.alive = true;
+
+        link(index);
+        activeCount++;
+
+        return (call.generation << INDEX_BITS) | (index + 1);
+    }
+
+    void tick() {
+        currentTick++;
+
+        // when a wheel wraps around, the next slot of the coarser wheel is spread over the finer ones
+        for (unsigned int level = 1; level < LEVELS; level++) {
+            if (((currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) break;
+            cascade(level);
+        }
+
+        dueCalls.clear();
+        takeSlot(currentTick & SLOT_MASK);
+
+        for (auto [index, generation] : dueCalls) {
+            // cancelled by an earlier callback of this tick
+            if (!calls[index].alive || calls[index].generation != generation) continue;
+
+            // the callback may schedule more calls and grow the array, so it is moved out while it runs
+            std::function<void()> callback = std::move(calls[index].callback);
+
+            if (calls[index].interval > 0) {
+                calls[index].expiry += calls[index].interval;
+                link(index);
+            }
+
+            callback();
+
+            ScheduledCall& call = calls[index];
+            if (!call.alive || call.generation != generation) continue; // cancelled by its own callback
+
+            if (call.interval > 0) call.callback = std::move(callback);
+            else release(index);
+        }
+    }
+}
+
+unsigned int scheduler::schedule(double delay, std::function<void()> callback) {
+    return add(toTicks(delay), 0, std::move(callback));
+}
+
+unsigned int scheduler::every(double interval, std::function<void()> callback) {
+    unsigned long long ticks = std::max(toTicks(interval), 1ull);
+    return add(ticks, ticks, std::move(callback));
+}
+
+void scheduler::cancel(unsigned int handle) {
+    ScheduledCall* call = findCall(handle);
+    if (call == nullptr) return;
+
+    unsigned int index = (handle & INDEX_MASK) - 1;
+
+    unlink(index);
+    release(index);
+}
+
+bool scheduler::isActive(unsigned int handle) { return findCall(handle) != nullptr; }
+
+double scheduler::getRemaining(unsigned int handle) {
+    ScheduledCall* call = findCall(handle);
+    if (call == nullptr || call->expiry <= currentTick) return 0.0;
+
+    return std::max(0.0, (double)(call->expiry - currentTick) - leftover);
+}
+
+void scheduler::clear() {
+    for (unsigned int i = 0; i < calls.size(); i++) {
+        if (!calls[i].alive) continue;
+
+        unlink(i);
+        release(i);
+    }
+}
+
+void scheduler::update(double milliseconds) {
+    if (!slotsReady) initSlots();
+    if (!(milliseconds > 0.0)) return;
+
+    leftover += milliseconds;
+
+    unsigned long long ticks = (unsigned long long)leftover;
+    leftover -= (double)ticks;
+
+    // nothing is waiting, so there is nothing to cascade or call
+    if (activeCount == 0) {
+        currentTick += ticks;
+        return;
+    }
+
+    for (unsigned long long i = 0; i < ticks; i++) tick();
+}
+
+unsigned int scheduler::getActiveCount() { return activeCount; }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * @brief Calls functions after a delay or at an interval. Scheduled calls are kept in a hierarchical timing wheel,
+ * so scheduling and cancelling cost the same no matter how many calls are waiting, and a frame only touches
+ * the calls that are due.
+ */
+namespace scheduler {
+    /**
+     * @brief Calls a function once after the delay.
+     *
+     * @param delay The delay in milliseconds. Resolution is 1 millisecond, calls are made in the frame the delay runs out.
+     * @param callback The function to call.
+     * @return The handle of the call, never 0.
+     */
+    unsigned int schedule(double delay, std::function<void()> callback);
+
+    /**
+     * @brief Calls a function every interval until it is cancelled. The first call is after one interval.
+     * Intervals don't drift, a late call doesn't push back the next one.
+     *
+     * @param interval The interval in milliseconds, at least 1 millisecond.
+     * @param callback The function to call.
+     * @return The handle of the call, never 0.
+     */
+    unsigned int every(double interval, std::function<void()> callback);
+
+    /**
+     * @brief Cancels a scheduled call. Handles of calls that already happened or were cancelled are ignored.
+     * A repeating call can cancel itself from its callback.
+     */
+    void cancel(unsigned int handle);
+
+    /**
+     * @brief Checks if a call is still waiting.
+     */
+    bool isActive(unsigned int handle);
+
+    /**
+     * @brief Gets the time left until the next call.
+     *
+     * @return The time in milliseconds, 0 if the call isn't active.
+     */
+    double getRemaining(unsigned int handle);
+
+    /**
+     * @brief Cancels all calls.
+     */
+    void clear();
+
+    /**
+     * @brief Advances the wheel and makes the calls that are due, in the order they are due.
+     * WARNING: This function is called automatically per frame by the engine.
+     *
+     * @param milliseconds The time since the last update.
+     */
+    void update(double milliseconds);
+
+    unsigned int getActiveCount();
+}
@@ -0,0 +1,345 @@
+#include "Solver.h"
+
+#include "Engine.h"
+#include "Jobs.h"
+
+#include "../classes/Entity.h"
+#include "../classes/Hitbox.h"
+
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    struct ContactConstraint {
+        int bodyA, bodyB; // -1 for objects that don't move
+        float inverseMassA, inverseMassB;
+
+        float normalX, normalY;
+        float depth;
+
+        float friction, restitution;
+        float normalMass;
+        float bias;
+
+        float normalImpulse, tangentImpulse; // accumulated over the iterations, kept for the next step
+
+        unsigned long long key;
+        unsigned int island;
+    };
+
+    constexpr float BAUMGARTE = 0.2f; // how much of the overlap is pushed out per step
+    constexpr float LINEAR_SLOP = 0.5f; // overlap that is allowed, so resting contacts don't jitter
+    constexpr float RESTITUTION_THRESHOLD = 0.05f; // slower impacts don't bounce
+    constexpr float SLEEP_VELOCITY = 0.01f;
+    constexpr float TIME_TO_SLEEP = 500.0f; // milliseconds
+    constexpr float DEFAULT_FRICTION = 0.5f; // for objects without a body
+
+    unsigned int iterations = 8;
+    bool sleepEnabled = true;
+    unsigned int lastIslandCount = 0;
+
+    std::vector<ContactConstraint> constraints;
+    std::vector<std::pair<unsigned int, unsigned int>> islandRanges; // constraint ranges of the awake islands
+
+    std::vector<unsigned int> islandParents; // union find over body indices
+    std::vector<unsigned char> islandAwake;
+    std::vector<float> islandSleepTime;
+
+    // impulses of the last step by contact pair, solving starts from them
+    std::unordered_map<unsigned long long, std::pair<float, float>> warmImpulses;
+
+    // where objects without a body were in the last step, a sleeping body they push against wakes up when they move
+    struct MoverPose {
+        float x, y, angle;
+        unsigned long long step;
+        bool moved; // the answer for this step, an object can be in many contacts
+    };
+
+    std::unordered_map<unsigned int, MoverPose> moverPoses;
+    unsigned long long solveStep = 0;
+
+    std::vector<unsigned int> pushedBodies;
+
+    unsigned int findRoot(unsigned int index) {
+        while (islandParents[index] != index) {
+            islandParents[index] = islandParents[islandParents[index]];
+            index = islandParents[index];
+        }
+
+        return index;
+    }
+
+    void unite(unsigned int a, unsigned int b) {
+        a = findRoot(a);
+        b = findRoot(b);
+
+        if (a != b) islandParents[std::max(a, b)] = std::min(a, b);
+    }
+
+    // records the pose of an object without a body, true if it moved since the last step it touched something
+    bool moverMoved(unsigned int id) {
+        const auto& objects = engine::getObjects();
+
+        auto it = objects.find(id);
+        if (it == objects.end() || it->second == nullptr) return false;
+
+        const Object& object = *it->second;
+        MoverPose pose = {object.getX(), object.getY(), object.getAngle(), solveStep, false};
+
+        auto [found, inserted] = moverPoses.try_emplace(id, pose);
+        if (inserted) return false;
+        if (found->second.step == solveStep) return found->second.moved;
+
+        // poses are only compared between consecutive steps, older ones are forgotten at the end of a step
+        pose.moved = found->second.x != pose.x || found->second.y != pose.y || found->second.angle != pose.angle;
+
+        found->second = pose;
+        return pose.moved;
+    }
+
+    // the body that moves for an object, hitboxes move their parent
+    int findBody(unsigned int id, const PhysicsBodies& bodies, float& friction, float& restitution) {
+        friction = DEFAULT_FRICTION;
+        restitution = 0.0f;
+
+        const auto& objects = engine::getObjects();
+
+        auto it = objects.find(id);
+        if (it == objects.end() || it->second == nullptr) return -1;
+
+        if (it->second->getType() == ObjectType::HITBOX) {
+            it = objects.find(static_cast<const Hitbox&>(*it->second).getParentID());
+            if (it == objects.end() || it->second == nullptr) return -1;
+        }
+
+        if (it->second->getType() != ObjectType::ENTITY) return -1;
+
+        unsigned int index = static_cast<const Entity&>(*it->second).getBodyIndex();
+
+        friction = bodies.friction[index];
+        restitution = bodies.restitution[index];
+
+        return bodies.enabled[index] != 0.0f ? (int)index : -1;
+    }
+
+    inline float inverseMass(const PhysicsBodies& bodies, int index) {
+        if (index < 0 || bodies.mass[index] <= 0.0f) return 0.0f;
+        return 1.0f / bodies.mass[index];
+    }
+
+    void applyImpulse(PhysicsBodies& bodies, const ContactConstraint& c, float impulseX, float impulseY) {
+        if (c.bodyA >= 0) {
+            bodies.velocityX[c.bodyA] -= c.inverseMassA * impulseX;
+            bodies.velocityY[c.bodyA] -= c.inverseMassA * impulseY;
+        }
+
+        if (c.bodyB >= 0) {
+            bodies.velocityX[c.bodyB] += c.inverseMassB * impulseX;
+            bodies.velocityY[c.bodyB] += c.inverseMassB * impulseY;
+        }
+    }
+
+    // velocity of b relative to a
+    inline void relativeVelocity(const PhysicsBodies& bodies, const ContactConstraint& c, float& vx, float& vy) {
+        vx = (c.bodyB >= 0 ? bodies.velocityX[c.bodyB] : 0.0f) - (c.bodyA >= 0 ? bodies.velocityX[c.bodyA] : 0.0f);
+        vy = (c.bodyB >= 0 ? bodies.velocityY[c.bodyB] : 0.0f) - (c.bodyA >= 0 ? bodies.velocityY[c.bodyA] : 0.0f);
+    }
+
+    void solveConstraint(PhysicsBodies& bodies, ContactConstraint& c) {
+        float vx, vy;
+
+        // normal impulse, only pushes
+        relativeVelocity(bodies, c, vx, vy);
+        float normalVelocity = vx * c.normalX + vy * c.normalY;
+
+        float lambda = c.normalMass * (-normalVelocity + c.bias);
+        float previous = c.normalImpulse;
+        c.normalImpulse = std::max(previous + lambda, 0.0f);
+        lambda = c.normalImpulse - previous;
+
+        applyImpulse(bodies, c, lambda * c.normalX, lambda * c.normalY);
+
+        // friction along the surface, limited by the normal impulse
+        float tangentX = -c.normalY, tangentY = c.normalX;
+
+        relativeVelocity(bodies, c, vx, vy);
+        float tangentVelocity = vx * tangentX + vy * tangentY;
+
+        float maxFriction = c.friction * c.normalImpulse;
+
+        lambda = c.normalMass * -tangentVelocity;
+        previous = c.tangentImpulse;
+        c.tangentImpulse = std::clamp(previous + lambda, -maxFriction, maxFriction);
+        lambda = c.tangentImpulse - previous;
+
+        applyImpulse(bodies, c, lambda * tangentX, lambda * tangentY);
+    }
+}
+
+void solver::solve(PhysicsBodies& bodies, const std::vector<ContactManifold>& contacts, float elapsedTime) {
+    if (elapsedTime <= 0.0f) return;
+
+    unsigned int count = bodies.owners.size();
+
+    islandParents.resize(count);
+    for (unsigned int i = 0; i < count; i++) islandParents[i] = i;
+
+    constraints.clear();
+    pushedBodies.clear();
+    solveStep++;
+
+    for (const ContactManifold& contact : contacts) {
+        float frictionA, restitutionA, frictionB, restitutionB;
+
+        int bodyA = findBody(contact.idA, bodies, frictionA, restitutionA);
+        int bodyB = findBody(contact.idB, bodies, frictionB, restitutionB);
+
+        if ((bodyA < 0 && bodyB < 0) || bodyA == bodyB) continue;
+
+        if (bodyA >= 0 && bodyB >= 0) unite(bodyA, bodyB);
+
+        // kinematic objects moved by game code or tweens don't have a body to be awake, so their motion wakes what they touch
+        if (bodyA < 0 && moverMoved(contact.idA)) pushedBodies.push_back(bodyB);
+        if (bodyB < 0 && moverMoved(contact.idB)) pushedBodies.push_back(bodyA);
+
+        ContactConstraint c = {};
+        c.bodyA = bodyA;
+        c.bodyB = bodyB;
+        c.normalX = contact.normalX;
+        c.normalY = contact.normalY;
+        c.depth = contact.depth;
+        c.friction = std::sqrt(frictionA * frictionB);
+        c.restitution = std::max(restitutionA, restitutionB);
+        c.key = ((unsigned long long)contact.idA << 32) | contact.idB;
+
+        constraints.push_back(c);
+    }
+
+    // an island with one awake body wakes up completely
+    islandAwake.assign(count, 0);
+
+    for (unsigned int i = 0; i < count; i++)
+        if (bodies.enabled[i] != 0.0f && bodies.awake[i] != 0.0f) islandAwake[findRoot(i)] = 1;
+
+    for (unsigned int body : pushedBodies) islandAwake[findRoot(body)] = 1;
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (bodies.enabled[i] == 0.0f || bodies.awake[i] != 0.0f || !islandAwake[findRoot(i)]) continue;
+
+        bodies.awake[i] = 1.0f;
+        bodies.sleepTime[i] = 0.0f;
+    }
+
+    // contacts of sleeping islands cost nothing
+    constraints.erase(std::remove_if(constraints.begin(), constraints.end(), [&](const ContactConstraint& c) {
+        int body = c.bodyA >= 0 ? c.bodyA : c.bodyB;
+        return !islandAwake[findRoot(body)];
+    }), constraints.end());
+
+    for (ContactConstraint& c : constraints) {
+        c.island = findRoot(c.bodyA >= 0 ? c.bodyA : c.bodyB);
+
+        c.inverseMassA = inverseMass(bodies, c.bodyA);
+        c.inverseMassB = inverseMass(bodies, c.bodyB);
+
+        float massSum = c.inverseMassA + c.inverseMassB;
+        c.normalMass = massSum > 0.0f ? 1.0f / massSum : 0.0f;
+
+        float vx, vy;
+        relativeVelocity(bodies, c, vx, vy);
+        float normalVelocity = vx * c.normalX + vy * c.normalY;
+
+        // push out the overlap over a few steps, and bounce fast impacts
+        c.bias = BAUMGARTE / elapsedTime * std::max(0.0f, c.depth - LINEAR_SLOP);
+        if (normalVelocity < -RESTITUTION_THRESHOLD) c.bias += -c.restitution * normalVelocity;
+
+        auto warm = warmImpulses.find(c.key);
+
+        if (warm != warmImpulses.end()) {
+            c.normalImpulse = warm->second.first;
+            c.tangentImpulse = warm->second.second;
+
+            float tangentX = -c.normalY, tangentY = c.normalX;
+            applyImpulse(bodies, c, c.normalImpulse * c.normalX + c.tangentImpulse * tangentX, c.normalImpulse * c.normalY + c.tangentImpulse * tangentY);
+        }
+    }
+
+    std::sort(constraints.begin(), constraints.end(), [](const ContactConstraint& a, const ContactConstraint& b) {
+        return a.island < b.island;
+    });
+
+    islandRanges.clear();
+
+    for (unsigned int begin = 0; begin < constraints.size();) {
+        unsigned int end = begin + 1;
+        while (end < constraints.size() && constraints[end].island == constraints[begin].island) end++;
+
+        islandRanges.push_back({begin, end});
+        begin = end;
+    }
+
+    // islands share no moving bodies, so each one can be solved on its own worker
+    jobs::parallelFor(islandRanges.size(), 1, [&](unsigned int begin, unsigned int end, unsigned int worker) {
+        for (unsigned int island = begin; island < end; island++) {
+            for (unsigned int iteration = 0; iteration < iterations; iteration++) {
+                for (unsigned int i = islandRanges[island].first; i < islandRanges[island].second; i++)
+                    solveConstraint(bodies, constraints[i]);
+            }
+        }
+    });
+
+    warmImpulses.clear();
+    for (const ContactConstraint& c : constraints) warmImpulses[c.key] = {c.normalImpulse, c.tangentImpulse};
+
+    // movers that stopped touching anything are forgotten
+    for (auto it = moverPoses.begin(); it != moverPoses.end();) {
+        if (it->second.step != solveStep) it = moverPoses.erase(it);
+        else ++it;
+    }
+
+    // an island sleeps when all of its bodies have been still for long enough
+    islandSleepTime.assign(count, INFINITY);
+    unsigned int islandCount = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (bodies.enabled[i] == 0.0f || bodies.awake[i] == 0.0f) continue;
+
+        float speed = bodies.velocityX[i] * bodies.velocityX[i] + bodies.velocityY[i] * bodies.velocityY[i];
+        bodies.sleepTime[i] = speed < SLEEP_VELOCITY * SLEEP_VELOCITY ? bodies.sleepTime[i] + elapsedTime : 0.0f;
+
+        unsigned int root = findRoot(i);
+        if (root == i) islandCount++;
+
+        islandSleepTime[root] = std::min(islandSleepTime[root], bodies.sleepTime[i]);
+    }
+
+    lastIslandCount = islandCount;
+
+    if (!sleepEnabled) return;
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (bodies.enabled[i] == 0.0f || bodies.awake[i] == 0.0f) continue;
+        if (islandSleepTime[findRoot(i)] < TIME_TO_SLEEP) continue;
+
+        bodies.awake[i] = 0.0f;
+        bodies.velocityX[i] = 0.0f;
+        bodies.velocityY[i] = 0.0f;
+    }
+}
+
+void solver::setIterations(unsigned int count) { iterations = std::max(1u, count); }
+
+void solver::setSleepEnabled(bool enabled) {
+    sleepEnabled = enabled;
+    if (enabled) return;
+
+    PhysicsBodies& bodies = physics::getBodies();
+
+    for (unsigned int i = 0; i < bodies.owners.size(); i++) {
+        bodies.awake[i] = 1.0f;
+        bodies.sleepTime[i] = 0.0f;
+    }
+}
+
+unsigned int solver::getLastIslandCount() { return lastIslandCount; }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Physics.h"
+#include "Collision.h"
+
+#include <vector>
+
+/**
+ * @brief Sequential impulse contact solver. Bodies connected by contacts form islands, islands are solved
+ * on all workers, and islands that stay still long enough go to sleep until something awake touches them.
+ * Bodies only move, contacts don't rotate them.
+ */
+namespace solver {
+    /**
+     * @brief Pushes touching bodies apart by changing their velocities, and puts still islands to sleep.
+     * Objects that aren't physics enabled entities are treated as immovable.
+     * WARNING: This function is called automatically by the physics step, between the velocity and the position update.
+     *
+     * @param bodies The bodies to solve.
+     * @param contacts Contacts from the last collision update.
+     * @param elapsedTime The time step.
+     */
+    void solve(PhysicsBodies& bodies, const std::vector<ContactManifold>& contacts, float elapsedTime);
+
+    /**
+     * @brief Sets how many times every contact is solved per step. More iterations make stacks stiffer. 8 by default.
+     */
+    void setIterations(unsigned int iterations);
+
+    /**
+     * @brief Sets if still islands can go to sleep. Enabled by default.
+     */
+    void setSleepEnabled(bool enabled);
+
+    /**
+     * @brief Gets how many awake islands were solved in the last step.
+     */
+    unsigned int getLastIslandCount();
+}
@@ -0,0 +1,285 @@
+#include "Textures.h"
+
+#include "Files.h"
+#include "Logger.h"
+#include "Engine.h"
+
+#include "../util/renderer/Atlas.h"
+
+#include <map>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+namespace {
+    struct TextureEntry {
+        std::string key;
+        int width;
+        int height;
+        unsigned int refCount;
+        int layers; // 0 for 2D textures
+    };
+
+    std::map<std::string, unsigned int> keyToTexture; // "name|flip" -> texture id
+    std::map<unsigned int, TextureEntry> loadedTextures;
+    std::map<std::string, SpriteFrame> atlasFrames; // sprite name -> page and uv rect, unflipped
+
+    bool destroyed = false;
+
+    std::string createKey(const std::string& spriteName, bool flip) {
+        return spriteName + (flip ? "|1" : "|0");
+    }
+
+    unsigned int upload(const std::string& spriteName, bool flip, int& width, int& height) {
+        std::string path = engine::getSpritePath(spriteName); // get sprite path from saved paths
+
+        // load image from file
+        Image loadedSprite = files::loadImage(path, flip);
+
+        if (!loadedSprite.isLoaded || !loadedSprite.data) {
+            logError("Failed to load sprite: " + spriteName, SPRITE_LOADING_ERROR);
+            return 0;
+        }
+
+        unsigned int spriteID;
+
+        // generate texture id
+        glGenTextures(1, &spriteID);
+        glBindTexture(GL_TEXTURE_2D, spriteID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // create texture from image
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, loadedSprite.width, loadedSprite.height, 0,
+            loadedSprite.nrChannels == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, loadedSprite.data);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        width = loadedSprite.width;
+        height = loadedSprite.height;
+
+        // we don't need the image data anymore
+        loadedSprite.free();
+
+        return spriteID;
+    }
+}
+
+unsigned int textures::acquire(const std::string& spriteName, bool flip) {
+    std::string key = createKey(spriteName, flip);
+
+    auto found = keyToTexture.find(key);
+
+    if (found != keyToTexture.end()) {
+        loadedTextures[found->second].refCount++;
+        return found->second;
+    }
+
+    int width, height;
+    unsigned int texture = upload(spriteName, flip, width, height);
+    if (texture == 0) return 0;
+
+    keyToTexture[key] = texture;
+    loadedTextures[texture] = {key, width, height, 1, 0};
+
+    destroyed = false;
+
+    return texture;
+}
+
+unsigned int textures::acquireArray(const std::vector<std::string>& spriteNames, bool flip) {
+    if (spriteNames.empty()) return 0;
+
+    std::string key = "#array";
+    for (auto& name : spriteNames) key += ":" + name;
+    key += flip ? "|1" : "|0";
+
+    auto found = keyToTexture.find(key);
+
+    if (found != keyToTexture.end()) {
+        loadedTextures[found->second].refCount++;
+        return found->second;
+    }
+
+    std::vector<Image> images;
+    bool valid = true;
+
+    for (auto& name : spriteNames) {
+        Image image = files::loadImage(engine::getSpritePath(name), flip);
+
+        if (!image.isLoaded || !image.data) {
+            logError("Failed to load sprite: " + name, SPRITE_LOADING_ERROR);
+            valid = false;
+            break;
+        }
+
+        images.push_back(image);
+
+        if (image.width != images[0].width || image.height != images[0].height) {
+            logError("Sprite size doesn't match the first frame of the texture array: " + name, SPRITE_LOADING_ERROR);
+            valid = false;
+            break;
+        }
+    }
+
+    if (!valid) {
+        for (auto& image : images) image.free();
+        return 0;
+    }
+
+    int width = images[0].width;
+    int height = images[0].height;
+
+    unsigned int arrayID;
+
+    glGenTextures(1, &arrayID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, images.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+    for (unsigned int i = 0; i < images.size(); i++) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1,
+            images[i].nrChannels == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, images[i].data);
+
+        images[i].free();
+    }
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    keyToTexture[key] = arrayID;
+    loadedTextures[arrayID] = {key, width, height, 1, (int)images.size()};
+
+    destroyed = false;
+
+    return arrayID;
+}
+
+SpriteFrame textures::acquireFrame(const std::string& spriteName, bool flip) {
+    auto found = atlasFrames.find(spriteName);
+
+    if (found != atlasFrames.end()) {
+        SpriteFrame frame = found->second;
+        retain(frame.texture);
+
+        // pages are stored flipped, the other way round only swaps the rows
+        if (!flip) std::swap(frame.v0, frame.v1);
+
+        return frame;
+    }
+
+    return {acquire(spriteName, flip), 0.0f, 0.0f, 1.0f, 1.0f};
+}
+
+unsigned int textures::buildAtlas(const std::vector<std::string>& spriteNames, int pageSize) {
+    std::vector<Image> images;
+    std::vector<std::string> names;
+
+    for (auto& name : spriteNames) {
+        Image image = files::loadImage(engine::getSpritePath(name), true);
+        if (!image.isLoaded) continue;
+
+        images.push_back(image);
+        names.push_back(name);
+    }
+
+    // tall images first pack tighter
+    std::vector<unsigned int> order(images.size());
+    for (unsigned int i = 0; i < order.size(); i++) order[i] = i;
+
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        return images[a].height > images[b].height;
+    });
+
+    Atlas atlas(pageSize);
+    std::vector<std::string> packedNames;
+
+    for (unsigned int i : order) {
+        if (atlas.add(names[i], images[i])) packedNames.push_back(names[i]);
+    }
+
+    for (auto& image : images) image.free();
+
+    std::vector<unsigned int> pages = atlas.upload();
+
+    for (unsigned int i = 0; i < pages.size(); i++)
+        loadedTextures[pages[i]] = {"#atlas" + std::to_string(i), pageSize, pageSize, 1, 0};
+
+    for (auto& name : packedNames) {
+        AtlasRegion region;
+        atlas.getRegion(name, region);
+
+        atlasFrames[name] = {region.page, region.u0, region.v0, region.u1, region.v1};
+    }
+
+    destroyed = false;
+
+    return pages.size();
+}
+
+bool textures::isInAtlas(const std::string& spriteName) {
+    return atlasFrames.find(spriteName) != atlasFrames.end();
+}
+
+bool textures::retain(unsigned int texture) {
+    auto found = loadedTextures.find(texture);
+    if (found == loadedTextures.end()) return false;
+
+    found->second.refCount++;
+    return true;
+}
+
+void textures::release(unsigned int texture) {
+    if (destroyed || texture == 0) return;
+
+    auto found = loadedTextures.find(texture);
+
+    // not ours, the caller owns it
+    if (found == loadedTextures.end()) {
+        glDeleteTextures(1, &texture);
+        return;
+    }
+
+    if (--found->second.refCount > 0) return;
+
+    keyToTexture.erase(found->second.key);
+    loadedTextures.erase(found);
+
+    glDeleteTextures(1, &texture);
+}
+
+unsigned int textures::getRefCount(unsigned int texture) {
+    auto found = loadedTextures.find(texture);
+    return found == loadedTextures.end() ? 0 : found->second.refCount;
+}
+
+bool textures::getSize(unsigned int texture, int& width, int& height) {
+    auto found = loadedTextures.find(texture);
+    if (found == loadedTextures.end()) return false;
+
+    width = found->second.width;
+    height = found->second.height;
+
+    return true;
+}
+
+unsigned int textures::getLoadedCount() {
+    return loadedTextures.size();
+}
+
+void textures::destroy() {
+    for (auto& [texture, entry] : loadedTextures) glDeleteTextures(1, &texture);
+
+    loadedTextures.clear();
+    keyToTexture.clear();
+    atlasFrames.clear();
+
+    destroyed = true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief A texture and the part of it a sprite uses. Sprites packed into an atlas share their page texture.
+ */
+struct SpriteFrame {
+    unsigned int texture;
+    float u0, v0, u1, v1;
+    float layer; /**< frame index when texture is a texture array. */
+    bool isArray; /**< whether texture is a GL_TEXTURE_2D_ARRAY. */
+};
+
+/**
+ * @brief Shared sprite textures. Each sprite is decoded and uploaded once, every user holds a reference
+ * and the texture is deleted when the last reference is released.
+ */
+namespace textures {
+    /**
+     * @brief Gets the texture of a saved sprite, loading it on first use, and adds a reference to it.
+     *
+     * @param spriteName The name of the sprite, as saved by the engine.
+     * @param flip Whether the image is flipped vertically. Flipped and unflipped versions are separate textures.
+     * @return The texture ID, or 0 if the sprite couldn't be loaded.
+     */
+    unsigned int acquire(const std::string& spriteName, bool flip = true);
+
+    /**
+     * @brief Gets the frame of a saved sprite and adds a reference to its texture.
+     * Sprites in the atlas return their page and UV rectangle, others are loaded the same way as acquire.
+     *
+     * @param spriteName The name of the sprite, as saved by the engine.
+     * @param flip Whether the image is flipped vertically.
+     * @return The frame, texture is 0 if the sprite couldn't be loaded.
+     */
+    SpriteFrame acquireFrame(const std::string& spriteName, bool flip = true);
+
+    /**
+     * @brief Loads same size sprites as the layers of one texture array and adds a reference to it.
+     * The same list of names in the same order shares the array.
+     *
+     * @param spriteNames The names of the sprites, layer i is spriteNames[i].
+     * @param flip Whether the images are flipped vertically.
+     * @return The texture ID, or 0 if a sprite couldn't be loaded or the sizes don't match.
+     */
+    unsigned int acquireArray(const std::vector<std::string>& spriteNames, bool flip = true);
+
+    /**
+     * @brief Packs saved sprites into shared atlas pages. Sprites larger than a page stay separate textures.
+     * The atlas keeps one reference to each page, so pages live until destroy is called.
+     *
+     * @param spriteNames The names of the sprites to pack.
+     * @param pageSize Width and height of a page in pixels.
+     * @return The number of pages created.
+     */
+    unsigned int buildAtlas(const std::vector<std::string>& spriteNames, int pageSize = 2048);
+
+    /**
+     * @brief Checks if a sprite was packed into the atlas.
+     */
+    bool isInAtlas(const std::string& spriteName);
+
+    /**
+     * @brief Adds a reference to a texture that is already managed.
+     *
+     * @param texture The texture ID.
+     * @return True if the texture is managed, false if it was created somewhere else.
+     */
+    bool retain(unsigned int texture);
+
+    /**
+     * @brief Removes a reference and deletes the texture when nobody uses it anymore.
+     * Textures that weren't created by the manager are deleted right away.
+     *
+     * @param texture The texture ID.
+     */
+    void release(unsigned int texture);
+
+    /**
+     * @brief Gets how many references a texture has.
+     *
+     * @param texture The texture ID.
+     * @return The reference count, 0 if the texture is not managed.
+     */
+    unsigned int getRefCount(unsigned int texture);
+
+    /**
+     * @brief Gets the size of a managed texture in pixels.
+     *
+     * @return False if the texture is not managed.
+     */
+    bool getSize(unsigned int texture, int& width, int& height);
+
+    /**
+     * @brief Gets how many textures are currently loaded.
+     */
+    unsigned int getLoadedCount();
+
+    /**
+     * @brief Deletes all textures. References released afterwards are ignored.
+     */
+    void destroy();
+}
@@ -1,13 +1,55 @@
 #include "Timer.h"
+#include "Files.h"
 
-#include <map>
+#include "../util/Histogram.h"
+
+#include <vector>
 #include <chrono>
 #include <ctime>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include <glad/glad.h>
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
 namespace {
-    std::map<unsigned int, std::chrono::steady_clock::time_point> timerMap;  // Map to store timer IDs and time points
+    // a handle is the slot index + 1 in the low bits and the slot's generation in the high bits,
+    // so a killed timer's handle stops working when the slot is reused and 0 is never a valid handle
+    constexpr unsigned int INDEX_BITS = 20;
+    constexpr unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+    constexpr unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    struct TimerSlot {
+        long long start; // nanoseconds on the steady clock
+        unsigned int generation;
+        bool alive;
+    };
+
+    std::vector<TimerSlot> timers;
+    std::vector<unsigned int> freeTimers;
+
+    long long frameNow = 0; // sampled once per frame by beginFrame
+
+    // OS sleeps can overshoot, so the last part of a wait is spent spinning on the clock
+    constexpr long long SPIN_MARGIN = 1000000; // nanoseconds
+
+#ifdef _WIN32
+    HANDLE waitableTimer = nullptr;
+#endif
 
     unsigned int benchmarkTimerID;
     unsigned int frameTimeCalcTimerID;
@@ -17,53 +59,203 @@ namespace {
     double averageFrameTime;
     double benchmarkResult;
     double lastFrameDuration;
+
+    // one series for frame times and one per phase, each with a sliding window over the last frames
+    struct TimeSeries {
+        Histogram window;
+        Histogram lifetime;
+
+        std::vector<double> recent; // values in the window, oldest at next once it is full
+        unsigned int next = 0;
+        unsigned int filled = 0;
+
+        double lifetimeMax = 0.0;
+    };
+
+    constexpr unsigned int PHASE_COUNT = (unsigned int)FramePhase::COUNT;
+
+    TimeSeries frameSeries;
+    TimeSeries phaseSeries[PHASE_COUNT];
+
+    std::atomic<unsigned long long> phaseTimes[PHASE_COUNT]; // nanoseconds spent in each phase in this frame
+
+    unsigned int statsWindow = 300;
+
+    FramePhase currentPhase = FramePhase::COUNT; // COUNT while no phase is running
+    double phaseStart = 0.0;
+
+    inline long long now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void addSample(TimeSeries& series, double milliseconds) {
+        if (series.recent.size() != statsWindow) {
+            series.recent.assign(statsWindow, 0.0);
+            series.next = 0;
+            series.filled = 0;
+            series.window.clear();
+        }
+
+        // the oldest value leaves the window when a new one comes in
+        if (series.filled == statsWindow) series.window.remove(series.recent[series.next]);
+        else series.filled++;
+
+        series.recent[series.next] = milliseconds;
+        series.next = (series.next + 1) % statsWindow;
+
+        series.window.record(milliseconds);
+        series.lifetime.record(milliseconds);
+        series.lifetimeMax = std::max(series.lifetimeMax, milliseconds);
+    }
+
+    FrameTimeStats makeStats(const Histogram& histogram, double max) {
+        FrameTimeStats stats;
+
+        stats.count = histogram.getCount();
+        stats.average = histogram.getAverage();
+        stats.p50 = histogram.getPercentile(50.0);
+        stats.p95 = histogram.getPercentile(95.0);
+        stats.p99 = histogram.getPercentile(99.0);
+        stats.max = max;
+
+        return stats;
+    }
+
+    FrameTimeStats windowStats(const TimeSeries& series) {
+        double max = 0.0;
+        for (unsigned int i = 0; i < series.filled; i++) max = std::max(max, series.recent[i]);
+
+        return makeStats(series.window, max);
+    }
+
+    std::string statsRow(const std::string& name, const std::string& range, const FrameTimeStats& stats) {
+        return name + "," + range + "," + std::to_string(stats.count) + "," + std::to_string(stats.average) + ","
+            + std::to_string(stats.p50) + "," + std::to_string(stats.p95) + "," + std::to_string(stats.p99) + ","
+            + std::to_string(stats.max) + "\n";
+    }
+
+    // sleeps roughly for the given time without using the cpu
+    void osSleep(long long nanoseconds) {
+#ifdef _WIN32
+        // the default sleep rounds up to the 15.6 ms system tick, high resolution timers don't
+        if (waitableTimer != nullptr) {
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -(nanoseconds / 100); // relative, in 100 ns units
+
+            if (SetWaitableTimer(waitableTimer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+                WaitForSingleObject(waitableTimer, INFINITE);
+                return;
+            }
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nanoseconds));
+    }
+
+    // the slot of a live handle, nullptr for 0, killed or stale handles
+    inline TimerSlot* findTimer(unsigned int id) {
+        unsigned int index = (id & INDEX_MASK) - 1;
+        if (index >= timers.size()) return nullptr;
+
+        TimerSlot& slot = timers[index];
+        if (!slot.alive || slot.generation != (id >> INDEX_BITS)) return nullptr;
+
+        return &slot;
+    }
 }
 
 void timer::init() {
+    frameNow = now();
+
+#ifdef _WIN32
+    if (waitableTimer == nullptr)
+        waitableTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+
     benchmarkTimerID = 0;
     frameTimeCalcTimerID = createTimer();
     totalRenderedFrames = 0;
     averageFrameTime = 0;
 }
 
+void timer::destroy() {
+#ifdef _WIN32
+    if (waitableTimer != nullptr) {
+        CloseHandle(waitableTimer);
+        waitableTimer = nullptr;
+    }
+#endif
+}
+
 unsigned int timer::createTimer() {
-    std::chrono::steady_clock::time_point timePoint;
-    unsigned int id = timerMap.size() + 1;  // Generate a unique ID
+    unsigned int index;
 
-    timePoint = std::chrono::steady_clock::now();  // start recording time
+    if (!freeTimers.empty()) {
+        index = freeTimers.back();
+        freeTimers.pop_back();
+    } else {
+        index = timers.size();
+        timers.push_back({0, 0, false});
+    }
 
-    timerMap.insert(std::pair<unsigned int, std::chrono::steady_clock::time_point>(id, timePoint));  // Insert the ID and time point into the map
+    TimerSlot& slot = timers[index];
+    slot.start = now();
+    slot.alive = true;
 
-    return id;
+    return (slot.generation << INDEX_BITS) | (index + 1);
 }
 
 void timer::resetTimer(unsigned int id) {
-    timerMap[id] = std::chrono::steady_clock::now();
+    if (TimerSlot* slot = findTimer(id)) slot->start = now();
+}
+
+void timer::resetTimerToFrame(unsigned int id) {
+    if (TimerSlot* slot = findTimer(id)) slot->start = frameNow;
 }
 
 void timer::killTimer(unsigned int id) {
-    timerMap.erase(id);
+    TimerSlot* slot = findTimer(id);
+    if (slot == nullptr) return;
+
+    slot->alive = false;
+    slot->generation = (slot->generation + 1) & GENERATION_MASK;
+
+    freeTimers.push_back((id & INDEX_MASK) - 1);
 }
 
+bool timer::isAlive(unsigned int id) { return findTimer(id) != nullptr; }
+
 double timer::getTimeDiff(unsigned int id) {
-    auto now = std::chrono::steady_clock::now();
-    auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(now - timerMap[id]).count() * .000001;  // Calculate the time difference in milliseconds
+    TimerSlot* slot = findTimer(id);
+    if (slot == nullptr) return 0.0;
 
-    return diff;
+    return (now() - slot->start) * .000001;  // Calculate the time difference in milliseconds
 }
 
-void timer::delay(double milliseconds) {
-    double ns = milliseconds * 1000000.0;
+void timer::beginFrame() { frameNow = now(); }
 
-    auto start = std::chrono::steady_clock::now();
+double timer::getFrameNow() { return frameNow * .000001; }
 
-    while (true) {
-        auto now = std::chrono::steady_clock::now();
-        auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+double timer::getFrameTimeDiff(unsigned int id) {
+    TimerSlot* slot = findTimer(id);
+    if (slot == nullptr) return 0.0;
 
-        if ((ns - diff) <= 0)
-            break;
-    }
+    return (frameNow - slot->start) * .000001;
+}
+
+double timer::getNow() { return now() * .000001; }
+
+void timer::sleepUntil(double deadline) {
+    long long target = (long long)(deadline * 1000000.0);
+    long long remaining = target - now();
+
+    if (remaining > SPIN_MARGIN) osSleep(remaining - SPIN_MARGIN);
+
+    while (now() < target) std::this_thread::yield();
+}
+
+void timer::delay(double milliseconds) {
+    if (milliseconds <= 0.0) return;
+    sleepUntil(getNow() + milliseconds);
 }
 
 std::string timer::getOStime() {
@@ -96,10 +288,82 @@ double benchmark::getBenchmarkResult() { return benchmarkResult; }
 double benchmark::getAverageFrameTime() { return averageFrameTime; }
 
 void benchmark::countFrames() {
+    beginPhase(FramePhase::COUNT);
+
     totalRenderedFrames++;
     lastFrameDuration = timer::getTimeDiff(frameTimeCalcTimerID);
     averageFrameTime = (averageFrameTime * (totalRenderedFrames-1) + lastFrameDuration) / totalRenderedFrames;
     timer::resetTimer(frameTimeCalcTimerID);
+
+    addSample(frameSeries, lastFrameDuration);
+
+    for (unsigned int i = 0; i < PHASE_COUNT; i++)
+        addSample(phaseSeries[i], phaseTimes[i].exchange(0, std::memory_order_relaxed) * .000001);
+}
+
+void benchmark::beginPhase(FramePhase phase) {
+    double now = timer::getNow();
+
+    if (currentPhase != FramePhase::COUNT) recordPhase(currentPhase, now - phaseStart);
+
+    currentPhase = phase;
+    phaseStart = now;
+}
+
+void benchmark::recordPhase(FramePhase phase, double milliseconds) {
+    if (phase == FramePhase::COUNT || !(milliseconds > 0.0)) return;
+    phaseTimes[(unsigned int)phase].fetch_add((unsigned long long)(milliseconds * 1000000.0), std::memory_order_relaxed);
+}
+
+void benchmark::setStatsWindow(unsigned int frames) {
+    statsWindow = std::max(1u, frames); // series resize and clear their windows on the next frame
+}
+
+unsigned int benchmark::getStatsWindow() { return statsWindow; }
+
+FrameTimeStats benchmark::getFrameStats() { return windowStats(frameSeries); }
+
+FrameTimeStats benchmark::getLifetimeFrameStats() { return makeStats(frameSeries.lifetime, frameSeries.lifetimeMax); }
+
+FrameTimeStats benchmark::getPhaseStats(FramePhase phase) {
+    if (phase == FramePhase::COUNT) return {};
+    return windowStats(phaseSeries[(unsigned int)phase]);
+}
+
+void benchmark::exportStats(const std::string& path) {
+    std::string data = "series,range,count,average_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+
+    data += statsRow("frame", "window", getFrameStats());
+    data += statsRow("frame", "lifetime", getLifetimeFrameStats());
+
+    for (unsigned int i = 0; i < PHASE_COUNT; i++) {
+        const TimeSeries& series = phaseSeries[i];
+        std::string name = getPhaseName((FramePhase)i);
+
+        data += statsRow(name, "window", windowStats(series));
+        data += statsRow(name, "lifetime", makeStats(series.lifetime, series.lifetimeMax));
+    }
+
+    // empty buckets are left out
+    data += "\nframe_time_up_to_ms,frames\n";
+
+    for (unsigned int i = 0; i < Histogram::BUCKET_COUNT; i++) {
+        unsigned long long count = frameSeries.lifetime.getBucketCount(i);
+        if (count != 0) data += std::to_string(Histogram::getBucketValue(i)) + "," + std::to_string(count) + "\n";
+    }
+
+    files::writeFile(path, data);
+}
+
+const char* benchmark::getPhaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::EVENTS: return "events";
+        case FramePhase::UPDATE: return "update";
+        case FramePhase::DRAW: return "draw";
+        case FramePhase::SWAP: return "swap";
+        case FramePhase::WAIT: return "wait";
+        default: return "unknown";
+    }
 }
 
 std::string benchmark::applyPrecision(double value, int precision) {
@@ -11,8 +11,15 @@ namespace timer {
      */
     void init();
 
+    /**
+     * @brief Releases the resources of the timer system, like the high resolution timer used for sleeping on Windows.
+     */
+    void destroy();
+
     /**
      * @brief Create a timer and return its ID.
+     * Timers live in one flat array and killed slots are reused. IDs carry the generation of their slot,
+     * so the ID of a killed timer stays invalid even after its slot is reused. 0 is never a valid ID.
      * @return The ID of the created timer.
      */
     unsigned int createTimer();
@@ -23,21 +30,64 @@ namespace timer {
      */
     void resetTimer(unsigned int id);
 
+    /**
+     * @brief Reset the timer to the time sampled at the start of the current frame, without reading the clock.
+     * @param id The ID of the timer to be reset.
+     */
+    void resetTimerToFrame(unsigned int id);
+
     /**
      * @brief Kills the timer associated with the given ID.
      * @param id The ID of the timer to be reset.
      */
     void killTimer(unsigned int id);
 
+    /**
+     * @brief Checks if the ID belongs to a timer that wasn't killed.
+     */
+    bool isAlive(unsigned int id);
+
     /**
      * @brief Get the time difference (in milliseconds) between the current time and the time associated with the given ID.
      * @param id The ID of the timer.
-     * @return The time difference in milliseconds.
+     * @return The time difference in milliseconds, 0 if the timer was killed.
      */
     double getTimeDiff(unsigned int id);
 
     /**
-     * @brief Stop the thread for a specific duration.
+     * @brief Samples the clock once for the frame. Frame relative queries use this sample instead of the clock.
+     * WARNING: This function is called automatically per frame by the engine.
+     */
+    void beginFrame();
+
+    /**
+     * @brief Gets the time sampled at the start of the current frame.
+     * @return The time in milliseconds on the steady clock.
+     */
+    double getFrameNow();
+
+    /**
+     * @brief Get the time difference (in milliseconds) between the start of the current frame and the time associated with the given ID.
+     * @param id The ID of the timer.
+     * @return The time difference in milliseconds, 0 if the timer was killed.
+     */
+    double getFrameTimeDiff(unsigned int id);
+
+    /**
+     * @brief Gets the current time on the steady clock.
+     * @return The time in milliseconds.
+     */
+    double getNow();
+
+    /**
+     * @brief Stops the thread until the given time. Sleeps with the OS timer for most of the wait
+     * and spins only for the last millisecond, so waiting barely uses the cpu but still wakes up on time.
+     * @param deadline The time to wake up at in milliseconds, on the same clock as getNow().
+     */
+    void sleepUntil(double deadline);
+
+    /**
+     * @brief Stop the thread for a specific duration. Works like sleepUntil.
      * @param milliseconds duration in milliseconds.
      */
     void delay(double milliseconds);
@@ -45,6 +95,28 @@ namespace timer {
     std::string getOStime();
 }
 
+/**
+ * @brief Parts of a frame that are timed separately.
+ */
+enum class FramePhase {
+    EVENTS, // polling input
+    UPDATE, // scene and object updates, physics, tweens, collisions
+    DRAW, // animations, recording and replaying draw commands
+    SWAP, // presenting the frame
+    WAIT, // sleeping for the fps cap
+    COUNT
+};
+
+/**
+ * @brief Statistics of a series of durations, all in milliseconds.
+ */
+struct FrameTimeStats {
+    unsigned long long count;
+    double average;
+    double p50, p95, p99;
+    double max;
+};
+
 namespace benchmark {
     /**
      * @brief Starts the benchmark timer.
@@ -73,6 +145,7 @@ namespace benchmark {
 
     /**
      * @brief Counts the total number of frames and calculates the average frame time.
+     * Ends the running phase and adds the frame and its phases to the statistics.
      */
     void countFrames();
 
@@ -82,6 +155,57 @@ namespace benchmark {
      */
     double getAverageFrameTime();
 
+    /**
+     * @brief Ends the running phase and starts timing another one. Time of a phase that runs
+     * more than once in a frame is added up.
+     * WARNING: This function is called automatically by the application loop and the engine.
+     *
+     * @param phase The phase that starts now.
+     */
+    void beginPhase(FramePhase phase);
+
+    /**
+     * @brief Adds time to a phase of the current frame. Can be called from any thread.
+     *
+     * @param phase The phase.
+     * @param milliseconds The time to add.
+     */
+    void recordPhase(FramePhase phase, double milliseconds);
+
+    /**
+     * @brief Sets how many of the last frames the rolling statistics cover. 300 by default.
+     * Clears the rolling statistics.
+     */
+    void setStatsWindow(unsigned int frames);
+
+    unsigned int getStatsWindow();
+
+    /**
+     * @brief Gets the frame time statistics of the last frames in the window.
+     * Percentiles are within about 3% of the real value, max is exact.
+     */
+    FrameTimeStats getFrameStats();
+
+    /**
+     * @brief Gets the frame time statistics of every frame since the start.
+     */
+    FrameTimeStats getLifetimeFrameStats();
+
+    /**
+     * @brief Gets the statistics of one phase over the last frames in the window.
+     */
+    FrameTimeStats getPhaseStats(FramePhase phase);
+
+    /**
+     * @brief Writes the rolling and lifetime statistics of the frame and every phase,
+     * and the lifetime frame time histogram, into a CSV file.
+     *
+     * @param path The path of the file.
+     */
+    void exportStats(const std::string& path);
+
+    const char* getPhaseName(FramePhase phase);
+
     /**
      * Applies precision to a double value and returns it as a string.
      *
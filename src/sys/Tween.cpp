@@ -0,0 +1,330 @@
+#include "Tween.h"
+
+#include "Engine.h"
+#include "Logger.h"
+
+#include "../util/FastMath.h"
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    struct TweenTarget {
+        TweenProperty property;
+        Object* object; // not owned, objects live until the engine is destroyed
+        float* pointer;
+        unsigned int objectID;
+    };
+
+    // one group per easing, each tween is one index in all arrays
+    struct TweenGroup {
+        std::vector<float> from;
+        std::vector<float> delta; // to - from
+        std::vector<float> elapsed;
+        std::vector<float> inverseDuration;
+        std::vector<float> value;
+
+        std::vector<TweenTarget> targets;
+        std::vector<unsigned int> handles;
+    };
+
+    struct TweenLocation {
+        unsigned int group;
+        unsigned int index;
+    };
+
+    TweenGroup groups[(int)Easing::COUNT];
+
+    std::unordered_map<unsigned int, TweenLocation> locations; // handle -> place in the groups
+    std::unordered_map<unsigned int, std::function<void()>> callbacks;
+
+    std::vector<unsigned int> finishedHandles;
+
+    unsigned int nextHandle = 1;
+
+    inline bool isCameraProperty(TweenProperty property) {
+        return property == TweenProperty::CAMERA_X_OFFSET || property == TweenProperty::CAMERA_Y_OFFSET || property == TweenProperty::CAMERA_ZOOM;
+    }
+
+    inline bool isObjectProperty(TweenProperty property) {
+        return !isCameraProperty(property) && property != TweenProperty::VALUE;
+    }
+
+    float readProperty(const TweenTarget& target) {
+        switch (target.property) {
+            case TweenProperty::X: return target.object->getX();
+            case TweenProperty::Y: return target.object->getY();
+            case TweenProperty::ANGLE: return target.object->getAngle();
+            case TweenProperty::WIDTH: return target.object->getWidth();
+            case TweenProperty::HEIGHT: return target.object->getHeight();
+            case TweenProperty::ALPHA: return target.object->getColor(0).a;
+            case TweenProperty::RED: return target.object->getColor(0).r * 255.0f;
+            case TweenProperty::GREEN: return target.object->getColor(0).g * 255.0f;
+            case TweenProperty::BLUE: return target.object->getColor(0).b * 255.0f;
+            case TweenProperty::CAMERA_X_OFFSET: return engine::getCamera()->getXOffset();
+            case TweenProperty::CAMERA_Y_OFFSET: return engine::getCamera()->getYOffset();
+            case TweenProperty::CAMERA_ZOOM: return engine::getCamera()->getZoom();
+            case TweenProperty::VALUE: return *target.pointer;
+        }
+
+        return 0.0f;
+    }
+
+    void writeProperty(const TweenTarget& target, float value) {
+        switch (target.property) {
+            case TweenProperty::X: target.object->setX(value); break;
+            case TweenProperty::Y: target.object->setY(value); break;
+            case TweenProperty::ANGLE: target.object->setRotation(value); break;
+            case TweenProperty::WIDTH: target.object->setWidth(value); break;
+            case TweenProperty::HEIGHT: target.object->setHeight(value); break;
+            case TweenProperty::ALPHA: target.object->setAlpha(value); break;
+            case TweenProperty::RED: target.object->setRed(value); break;
+            case TweenProperty::GREEN: target.object->setGreen(value); break;
+            case TweenProperty::BLUE: target.object->setBlue(value); break;
+            case TweenProperty::CAMERA_X_OFFSET: engine::getCamera()->setXOffset(value); break;
+            case TweenProperty::CAMERA_Y_OFFSET: engine::getCamera()->setYOffset(value); break;
+            case TweenProperty::CAMERA_ZOOM: engine::getCamera()->setZoom(value); break;
+            case TweenProperty::VALUE: *target.pointer = value; break;
+        }
+    }
+
+    unsigned int start(const TweenTarget& target, float from, float to, double duration, Easing easing) {
+        unsigned int groupIndex = std::min((unsigned int)easing, (unsigned int)Easing::COUNT - 1);
+        TweenGroup& group = groups[groupIndex];
+
+        unsigned int handle = nextHandle++;
+
+        group.from.push_back(from);
+        group.delta.push_back(to - from);
+        group.elapsed.push_back(0.0f);
+        group.inverseDuration.push_back(duration > 0 ? (float)(1.0 / duration) : 1e30f); // zero duration ends on the first update
+        group.value.push_back(from);
+        group.targets.push_back(target);
+        group.handles.push_back(handle);
+
+        locations[handle] = {groupIndex, (unsigned int)group.handles.size() - 1};
+
+        return handle;
+    }
+
+    void removeAt(unsigned int groupIndex, unsigned int index) {
+        TweenGroup& group = groups[groupIndex];
+        unsigned int last = group.handles.size() - 1;
+
+        locations.erase(group.handles[index]);
+
+        // move the last tween into the gap
+        if (index != last) {
+            group.from[index] = group.from[last];
+            group.delta[index] = group.delta[last];
+            group.elapsed[index] = group.elapsed[last];
+            group.inverseDuration[index] = group.inverseDuration[last];
+            group.value[index] = group.value[last];
+            group.targets[index] = group.targets[last];
+            group.handles[index] = group.handles[last];
+
+            locations[group.handles[index]].index = index;
+        }
+
+        group.from.pop_back();
+        group.delta.pop_back();
+        group.elapsed.pop_back();
+        group.inverseDuration.pop_back();
+        group.value.pop_back();
+        group.targets.pop_back();
+        group.handles.pop_back();
+    }
+
+    // branch free, so the compiler can vectorize the loop for every curve
+    template<typename Curve>
+    void evaluate(TweenGroup& group, float milliseconds, Curve curve) {
+        unsigned int count = group.handles.size();
+
+        const float* __restrict from = group.from.data();
+        const float* __restrict delta = group.delta.data();
+        const float* __restrict inverseDuration = group.inverseDuration.data();
+        float* __restrict elapsed = group.elapsed.data();
+        float* __restrict value = group.value.data();
+
+        for (unsigned int i = 0; i < count; i++) {
+            elapsed[i] += milliseconds;
+
+            // clamp to 1 with a mask, std::min keeps a branch in the loop
+            float progress = elapsed[i] * inverseDuration[i];
+            float over = progress > 1.0f ? 1.0f : 0.0f;
+            float t = progress + over * (1.0f - progress);
+
+            value[i] = from[i] + delta[i] * curve(t);
+        }
+    }
+
+    // curves, the in-out ones use masks instead of branches
+    inline float linear(float t) { return t; }
+    inline float quadIn(float t) { return t * t; }
+    inline float quadOut(float t) { return t * (2.0f - t); }
+    inline float cubicIn(float t) { return t * t * t; }
+    inline float sineIn(float t) { return 1.0f - fastmath::cos(t * fastmath::HALF_PI); }
+    inline float sineOut(float t) { return fastmath::sin(t * fastmath::HALF_PI); }
+    inline float sineInOut(float t) { return 0.5f - 0.5f * fastmath::cos(t * fastmath::PI); }
+
+    inline float cubicOut(float t) {
+        float u = 1.0f - t;
+        return 1.0f - u * u * u;
+    }
+
+    inline float quadInOut(float t) {
+        float m = t < 0.5f ? 1.0f : 0.0f;
+        float u = -2.0f * t + 2.0f;
+        return m * (2.0f * t * t) + (1.0f - m) * (1.0f - u * u * 0.5f);
+    }
+
+    inline float cubicInOut(float t) {
+        float m = t < 0.5f ? 1.0f : 0.0f;
+        float u = -2.0f * t + 2.0f;
+        return m * (4.0f * t * t * t) + (1.0f - m) * (1.0f - u * u * u * 0.5f);
+    }
+
+    inline float backOut(float t) {
+        const float c1 = 1.70158f;
+        const float c3 = c1 + 1.0f;
+        float u = t - 1.0f;
+        return 1.0f + c3 * u * u * u + c1 * u * u;
+    }
+
+    void evaluateGroup(Easing easing, TweenGroup& group, float milliseconds) {
+        switch (easing) {
+            case Easing::LINEAR: evaluate(group, milliseconds, linear); break;
+            case Easing::QUAD_IN: evaluate(group, milliseconds, quadIn); break;
+            case Easing::QUAD_OUT: evaluate(group, milliseconds, quadOut); break;
+            case Easing::QUAD_IN_OUT: evaluate(group, milliseconds, quadInOut); break;
+            case Easing::CUBIC_IN: evaluate(group, milliseconds, cubicIn); break;
+            case Easing::CUBIC_OUT: evaluate(group, milliseconds, cubicOut); break;
+            case Easing::CUBIC_IN_OUT: evaluate(group, milliseconds, cubicInOut); break;
+            case Easing::SINE_IN: evaluate(group, milliseconds, sineIn); break;
+            case Easing::SINE_OUT: evaluate(group, milliseconds, sineOut); break;
+            case Easing::SINE_IN_OUT: evaluate(group, milliseconds, sineInOut); break;
+            case Easing::BACK_OUT: evaluate(group, milliseconds, backOut); break;
+            default: break;
+        }
+    }
+}
+
+unsigned int tween::toObject(unsigned int objectID, TweenProperty property, float to, double duration, Easing easing) {
+    if (!isObjectProperty(property)) {
+        logError("Camera and value properties can't be tweened on an object.", INVALID_TWEEN_PROPERTY);
+        return 0;
+    }
+
+    // getObject would add an empty entry for an unknown ID
+    const auto& objects = engine::getObjects();
+    auto found = objects.find(objectID);
+
+    if (found == objects.end() || found->second == nullptr) {
+        logError("Can't tween object " + std::to_string(objectID) + ", it doesn't exist.", OBJECT_NOT_FOUND);
+        return 0;
+    }
+
+    TweenTarget target = {property, found->second.get(), nullptr, objectID};
+
+    return start(target, readProperty(target), to, duration, easing);
+}
+
+unsigned int tween::toCamera(TweenProperty property, float to, double duration, Easing easing) {
+    if (!isCameraProperty(property)) {
+        logError("Only camera properties can be tweened on the camera.", INVALID_TWEEN_PROPERTY);
+        return 0;
+    }
+
+    TweenTarget target = {property, nullptr, nullptr, 0};
+
+    return start(target, readProperty(target), to, duration, easing);
+}
+
+unsigned int tween::toValue(float* target, float from, float to, double duration, Easing easing) {
+    return start({TweenProperty::VALUE, nullptr, target, 0}, from, to, duration, easing);
+}
+
+void tween::onComplete(unsigned int handle, std::function<void()> callback) {
+    if (isActive(handle)) callbacks[handle] = callback;
+}
+
+void tween::cancel(unsigned int handle) {
+    auto found = locations.find(handle);
+    if (found == locations.end()) return;
+
+    callbacks.erase(handle);
+    removeAt(found->second.group, found->second.index);
+}
+
+void tween::cancelObject(unsigned int objectID) {
+    for (unsigned int g = 0; g < (unsigned int)Easing::COUNT; g++) {
+        TweenGroup& group = groups[g];
+
+        for (unsigned int i = group.handles.size(); i-- > 0;) {
+            if (group.targets[i].object == nullptr || group.targets[i].objectID != objectID) continue;
+
+            callbacks.erase(group.handles[i]);
+            removeAt(g, i);
+        }
+    }
+}
+
+bool tween::isActive(unsigned int handle) {
+    return locations.find(handle) != locations.end();
+}
+
+void tween::update(double milliseconds) {
+    finishedHandles.clear();
+
+    for (unsigned int g = 0; g < (unsigned int)Easing::COUNT; g++) {
+        TweenGroup& group = groups[g];
+        if (group.handles.empty()) continue;
+
+        evaluateGroup((Easing)g, group, (float)milliseconds);
+
+        // writes go through the setters, so moved objects get their transforms updated
+        for (unsigned int i = 0; i < group.handles.size(); i++) {
+            writeProperty(group.targets[i], group.value[i]);
+
+            if (group.elapsed[i] * group.inverseDuration[i] >= 1.0f) finishedHandles.push_back(group.handles[i]);
+        }
+    }
+
+    for (unsigned int handle : finishedHandles) {
+        auto callback = callbacks.find(handle);
+        std::function<void()> onDone;
+
+        if (callback != callbacks.end()) {
+            onDone = callback->second;
+            callbacks.erase(callback);
+        }
+
+        cancel(handle);
+
+        // may start new tweens, so it runs after the tween is removed
+        if (onDone) onDone();
+    }
+}
+
+unsigned int tween::getActiveCount() {
+    return locations.size();
+}
+
+float tween::ease(Easing easing, float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+
+    switch (easing) {
+        case Easing::QUAD_IN: return quadIn(t);
+        case Easing::QUAD_OUT: return quadOut(t);
+        case Easing::QUAD_IN_OUT: return quadInOut(t);
+        case Easing::CUBIC_IN: return cubicIn(t);
+        case Easing::CUBIC_OUT: return cubicOut(t);
+        case Easing::CUBIC_IN_OUT: return cubicInOut(t);
+        case Easing::SINE_IN: return sineIn(t);
+        case Easing::SINE_OUT: return sineOut(t);
+        case Easing::SINE_IN_OUT: return sineInOut(t);
+        case Easing::BACK_OUT: return backOut(t);
+        default: return linear(t);
+    }
+}
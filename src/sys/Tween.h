@@ -0,0 +1,103 @@
+#pragma once
+
+#include <functional>
+
+enum class Easing {
+    LINEAR,
+    QUAD_IN,
+    QUAD_OUT,
+    QUAD_IN_OUT,
+    CUBIC_IN,
+    CUBIC_OUT,
+    CUBIC_IN_OUT,
+    SINE_IN,
+    SINE_OUT,
+    SINE_IN_OUT,
+    BACK_OUT, // overshoots a little before settling
+    COUNT
+};
+
+enum class TweenProperty {
+    X,
+    Y,
+    ANGLE,
+    WIDTH,
+    HEIGHT,
+    ALPHA, // alpha of all vertices, colors are kept
+    RED, // color channels of all vertices (0.0 - 255.0), the other channels are kept
+    GREEN,
+    BLUE,
+    CAMERA_X_OFFSET,
+    CAMERA_Y_OFFSET,
+    CAMERA_ZOOM,
+    VALUE // any float given by pointer
+};
+
+/**
+ * @brief Interpolates float properties over time. Tweens with the same easing are stored together as arrays
+ * and evaluated by one loop per easing, results are written to their targets afterwards.
+ */
+namespace tween {
+    /**
+     * @brief Starts animating a property of an object from its current value.
+     *
+     * @param objectID The ID of the object.
+     * @param property One of the object properties (X, Y, ANGLE, WIDTH, HEIGHT, ALPHA, RED, GREEN, BLUE).
+     * Tween RED, GREEN and BLUE together to fade between two colors.
+     * @param to The final value.
+     * @param duration The duration in milliseconds.
+     * @param easing The curve of the motion.
+     * @return The handle of the tween, 0 if the object doesn't exist or the property isn't an object property.
+     */
+    unsigned int toObject(unsigned int objectID, TweenProperty property, float to, double duration, Easing easing = Easing::QUAD_OUT);
+
+    /**
+     * @brief Starts animating a property of the current camera from its current value.
+     *
+     * @param property One of the camera properties (CAMERA_X_OFFSET, CAMERA_Y_OFFSET, CAMERA_ZOOM).
+     * @return The handle of the tween, 0 if the property isn't a camera property.
+     */
+    unsigned int toCamera(TweenProperty property, float to, double duration, Easing easing = Easing::QUAD_OUT);
+
+    /**
+     * @brief Starts animating a float. The float must outlive the tween.
+     *
+     * @return The handle of the tween, never 0.
+     */
+    unsigned int toValue(float* target, float from, float to, double duration, Easing easing = Easing::QUAD_OUT);
+
+    /**
+     * @brief Sets a function that is called once when the tween reaches its final value.
+     */
+    void onComplete(unsigned int handle, std::function<void()> callback);
+
+    /**
+     * @brief Stops a tween where it is. The completion callback is not called.
+     */
+    void cancel(unsigned int handle);
+
+    /**
+     * @brief Stops all tweens of an object.
+     */
+    void cancelObject(unsigned int objectID);
+
+    bool isActive(unsigned int handle);
+
+    /**
+     * @brief Advances all tweens and writes the new values.
+     * WARNING: This function is called automatically per frame by the engine.
+     *
+     * @param milliseconds The time since the last update.
+     */
+    void update(double milliseconds);
+
+    unsigned int getActiveCount();
+
+    /**
+     * @brief Evaluates an easing curve.
+     *
+     * @param easing The curve.
+     * @param t Progress between 0 and 1.
+     */
+    float ease(Easing easing, float t);
+}
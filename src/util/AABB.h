@@ -0,0 +1,27 @@
+#pragma once
+
+#include <algorithm>
+
+/**
+ * @brief Axis aligned bounding box.
+ */
+struct AABB {
+    float minX, minY;
+    float maxX, maxY;
+
+    inline bool overlaps(const AABB& other) const {
+        return minX < other.maxX && maxX > other.minX && minY < other.maxY && maxY > other.minY;
+    }
+
+    inline bool contains(const AABB& other) const {
+        return minX <= other.minX && minY <= other.minY && maxX >= other.maxX && maxY >= other.maxY;
+    }
+
+    inline float getPerimeter() const {
+        return 2.0f * ((maxX - minX) + (maxY - minY));
+    }
+
+    static inline AABB combine(const AABB& a, const AABB& b) {
+        return {std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+    }
+};
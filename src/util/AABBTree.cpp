@@ -0,0 +1,330 @@
+#include "AABBTree.h"
+
+#include <cmath>
+#include <algorithm>
+
+AABBTree::AABBTree(float margin) {
+    this->margin = margin;
+
+    root = -1;
+    freeList = -1;
+    proxyCount = 0;
+}
+
+void AABBTree::setMargin(float margin) { this->margin = margin; }
+
+int AABBTree::allocateNode() {
+    if (freeList == -1) {
+        nodes.push_back({});
+        freeList = nodes.size() - 1;
+        nodes[freeList].parent = -1;
+    }
+
+    int index = freeList;
+    freeList = nodes[index].parent;
+
+    Node& node = nodes[index];
+    node.parent = -1;
+    node.left = -1;
+    node.right = -1;
+    node.height = 0;
+    node.id = 0;
+
+    return index;
+}
+
+void AABBTree::freeNode(int index) {
+    nodes[index].parent = freeList;
+    nodes[index].height = -1;
+    freeList = index;
+}
+
+int AABBTree::insert(unsigned int id, const AABB& box) {
+    int leaf = allocateNode();
+
+    nodes[leaf].box = {box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin};
+    nodes[leaf].id = id;
+
+    insertLeaf(leaf);
+    proxyCount++;
+
+    return leaf;
+}
+
+void AABBTree::remove(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool AABBTree::move(int proxy, const AABB& box) {
+    if (nodes[proxy].box.contains(box)) return false;
+
+    removeLeaf(proxy);
+    nodes[proxy].box = {box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin};
+    insertLeaf(proxy);
+
+    return true;
+}
+
+unsigned int AABBTree::getId(int proxy) const { return nodes[proxy].id; }
+const AABB& AABBTree::getFatAABB(int proxy) const { return nodes[proxy].box; }
+
+void AABBTree::insertLeaf(int leaf) {
+    if (root == -1) {
+        root = leaf;
+        nodes[root].parent = -1;
+        return;
+    }
+
+    const AABB box = nodes[leaf].box;
+
+    // walk down to the sibling that grows the total perimeter the least
+    int index = root;
+
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+
+        float perimeter = node.box.getPerimeter();
+        float combined = AABB::combine(node.box, box).getPerimeter();
+
+        // cost of a new parent here, and the growth every child path has to pay
+        float cost = 2.0f * combined;
+        float inheritance = 2.0f * (combined - perimeter);
+
+        float costs[2];
+        int children[2] = {node.left, node.right};
+
+        for (int i = 0; i < 2; i++) {
+            const Node& child = nodes[children[i]];
+            float grown = AABB::combine(child.box, box).getPerimeter();
+
+            costs[i] = (child.isLeaf() ? grown : grown - child.box.getPerimeter()) + inheritance;
+        }
+
+        if (cost < costs[0] && cost < costs[1]) break;
+
+        index = costs[0] < costs[1] ? children[0] : children[1];
+    }
+
+    int sibling = index;
+    int oldParent = nodes[sibling].parent;
+
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = AABB::combine(box, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == -1) root = newParent;
+    else if (nodes[oldParent].left == sibling) nodes[oldParent].left = newParent;
+    else nodes[oldParent].right = newParent;
+
+    refit(nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    freeNode(parent);
+
+    // the sibling takes the place of the parent
+    nodes[sibling].parent = grandParent;
+    nodes[leaf].parent = -1;
+
+    if (grandParent == -1) {
+        root = sibling;
+        return;
+    }
+
+    if (nodes[grandParent].left == parent) nodes[grandParent].left = sibling;
+    else nodes[grandParent].right = sibling;
+
+    refit(grandParent);
+}
+
+void AABBTree::refit(int index) {
+    while (index != -1) {
+        index = balance(index);
+
+        Node& node = nodes[index];
+        const Node& left = nodes[node.left];
+        const Node& right = nodes[node.right];
+
+        node.height = 1 + std::max(left.height, right.height);
+        node.box = AABB::combine(left.box, right.box);
+
+        index = node.parent;
+    }
+}
+
+int AABBTree::balance(int a) {
+    if (nodes[a].isLeaf() || nodes[a].height < 2) return a;
+
+    int b = nodes[a].left;
+    int c = nodes[a].right;
+
+    int difference = nodes[c].height - nodes[b].height;
+    if (difference >= -1 && difference <= 1) return a;
+
+    // the deeper child takes the place of a, a takes the shallower grandchild
+    int up = difference > 1 ? c : b;
+    int other = difference > 1 ? b : c;
+
+    int f = nodes[up].left;
+    int g = nodes[up].right;
+
+    nodes[up].left = a;
+    nodes[up].parent = nodes[a].parent;
+    nodes[a].parent = up;
+
+    int parent = nodes[up].parent;
+
+    if (parent == -1) root = up;
+    else if (nodes[parent].left == a) nodes[parent].left = up;
+    else nodes[parent].right = up;
+
+    // the deeper grandchild stays under the new subtree root
+    int keep = nodes[f].height > nodes[g].height ? f : g;
+    int give = keep == f ? g : f;
+
+    nodes[up].right = keep;
+
+    if (difference > 1) nodes[a].right = give;
+    else nodes[a].left = give;
+
+    nodes[give].parent = a;
+
+    nodes[a].box = AABB::combine(nodes[other].box, nodes[give].box);
+    nodes[a].height = 1 + std::max(nodes[other].height, nodes[give].height);
+
+    nodes[up].box = AABB::combine(nodes[a].box, nodes[keep].box);
+    nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+
+    return up;
+}
+
+void AABBTree::query(const AABB& area, const std::function<bool(int)>& callback) const {
+    if (root == -1) return;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+        if (!node.box.overlaps(area)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(index)) return;
+            continue;
+        }
+
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+}
+
+void AABBTree::raycast(float x1, float y1, float x2, float y2, const std::function<float(int, float)>& callback) const {
+    if (root == -1) return;
+
+    float dx = x2 - x1, dy = y2 - y1;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length <= 0.0f) return;
+
+    // normal of the segment, a box is missed if its projection on the normal doesn't reach the line
+    float normalX = -dy / length, normalY = dx / length;
+    float absNormalX = std::fabs(normalX), absNormalY = std::fabs(normalY);
+
+    float maxFraction = 1.0f;
+
+    AABB segment = {std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2)};
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+
+        // the slab tests use <= so axis aligned segments on a box edge still hit
+        if (node.box.minX > segment.maxX || node.box.maxX < segment.minX) continue;
+        if (node.box.minY > segment.maxY || node.box.maxY < segment.minY) continue;
+
+        float centerX = (node.box.minX + node.box.maxX) * 0.5f, centerY = (node.box.minY + node.box.maxY) * 0.5f;
+        float extentX = (node.box.maxX - node.box.minX) * 0.5f, extentY = (node.box.maxY - node.box.minY) * 0.5f;
+
+        float separation = std::fabs(normalX * (x1 - centerX) + normalY * (y1 - centerY)) - (absNormalX * extentX + absNormalY * extentY);
+        if (separation > 0.0f) continue;
+
+        if (!node.isLeaf()) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        float fraction = callback(index, maxFraction);
+        if (fraction == 0.0f) return;
+
+        if (fraction > 0.0f && fraction < maxFraction) {
+            // shorten the segment so farther boxes are skipped
+            maxFraction = fraction;
+
+            float endX = x1 + dx * maxFraction, endY = y1 + dy * maxFraction;
+            segment = {std::min(x1, endX), std::min(y1, endY), std::max(x1, endX), std::max(y1, endY)};
+        }
+    }
+}
+
+void AABBTree::findPairs(std::vector<std::pair<int, int>>& pairs) const {
+    for (int leaf = 0; leaf < (int)nodes.size(); leaf++) {
+        const Node& node = nodes[leaf];
+        if (node.height != 0) continue;
+
+        // every pair is found from both sides, keep the one from the smaller proxy
+        query(node.box, [&](int other) {
+            if (other > leaf) pairs.push_back({leaf, other});
+            return true;
+        });
+    }
+}
+
+void AABBTree::findPairs(const AABBTree& other, std::vector<std::pair<int, int>>& pairs) const {
+    for (int leaf = 0; leaf < (int)nodes.size(); leaf++) {
+        const Node& node = nodes[leaf];
+        if (node.height != 0) continue;
+
+        other.query(node.box, [&](int proxy) {
+            pairs.push_back({leaf, proxy});
+            return true;
+        });
+    }
+}
+
+void AABBTree::clear() {
+    nodes.clear();
+
+    root = -1;
+    freeList = -1;
+    proxyCount = 0;
+}
+
+int AABBTree::getHeight() const { return root == -1 ? 0 : nodes[root].height; }
+unsigned int AABBTree::getProxyCount() const { return proxyCount; }
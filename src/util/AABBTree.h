@@ -0,0 +1,113 @@
+#pragma once
+
+#include "AABB.h"
+
+#include <vector>
+#include <utility>
+#include <functional>
+
+/**
+ * @brief Dynamic bounding volume tree. Every leaf is a fattened box around one proxy, so small movements
+ * don't change the tree. Inner nodes are kept balanced with rotations like an AVL tree.
+ * Queries don't change the tree, they can run on many threads at once.
+ */
+class AABBTree {
+public:
+    /**
+     * @param margin How much leaf boxes are enlarged on each side.
+     */
+    AABBTree(float margin = 4.0f);
+
+    /**
+     * @brief Sets how much leaf boxes are enlarged. Only affects boxes inserted or reinserted after the call.
+     */
+    void setMargin(float margin);
+
+    /**
+     * @brief Adds a box to the tree.
+     *
+     * @param id The value returned for this proxy by getId.
+     * @param box The tight bounds of the proxy.
+     * @return The proxy index, stays the same until the proxy is removed.
+     */
+    int insert(unsigned int id, const AABB& box);
+
+    void remove(int proxy);
+
+    /**
+     * @brief Updates the bounds of a proxy. The leaf is only reinserted if the box left its fat box.
+     *
+     * @return True if the tree changed.
+     */
+    bool move(int proxy, const AABB& box);
+
+    unsigned int getId(int proxy) const;
+    const AABB& getFatAABB(int proxy) const;
+
+    /**
+     * @brief Calls the callback for every proxy whose fat box overlaps an area.
+     *
+     * @param callback Gets the proxy index, returns false to stop the query.
+     */
+    void query(const AABB& area, const std::function<bool(int)>& callback) const;
+
+    /**
+     * @brief Calls the callback for every proxy whose fat box is crossed by the segment from (x1, y1) to (x2, y2).
+     *
+     * @param callback Gets the proxy index and the current max fraction of the segment.
+     * Returns the new max fraction, 0 stops the cast, the same value continues unchanged.
+     */
+    void raycast(float x1, float y1, float x2, float y2, const std::function<float(int, float)>& callback) const;
+
+    /**
+     * @brief Finds every pair of proxies in this tree with overlapping fat boxes.
+     *
+     * @param pairs Pairs of proxy indices are appended, each pair once.
+     */
+    void findPairs(std::vector<std::pair<int, int>>& pairs) const;
+
+    /**
+     * @brief Finds every pair of a proxy in this tree and a proxy in another tree with overlapping fat boxes.
+     *
+     * @param pairs (proxy in this tree, proxy in other tree) pairs are appended.
+     */
+    void findPairs(const AABBTree& other, std::vector<std::pair<int, int>>& pairs) const;
+
+    void clear();
+
+    int getHeight() const;
+    unsigned int getProxyCount() const;
+
+private:
+    struct Node {
+        AABB box;
+
+        int parent; // next free node while the node is unused
+        int left, right; // -1 for leaves
+        int height; // 0 for leaves, -1 for unused nodes
+
+        unsigned int id;
+
+        inline bool isLeaf() const { return left == -1; }
+    };
+
+    int allocateNode();
+    void freeNode(int index);
+
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+
+    // rotates the subtree at index if one side is more than one level deeper, returns the new subtree root
+    int balance(int index);
+
+    // recomputes box and height from the children, walking up to the root
+    void refit(int index);
+
+    std::vector<Node> nodes;
+
+    int root;
+    int freeList;
+    unsigned int proxyCount;
+
+    float margin;
+};
@@ -1,75 +1,83 @@
 #include "Animation.h"
 
-#include "../sys/Files.h"
+#include "../sys/Textures.h"
 #include "../sys/Logger.h"
 #include "../sys/Engine.h"
-#include "../sys/Timer.h"
+#include "../sys/Animator.h"
 
 #include <glad/glad.h>
+#include <algorithm>
 
 Animation::Animation(int fps, float speed) {
-    calculateFrameTime(fps, speed);
-
-    currentKeyframe = 0;
-    animTimerID = timer::createTimer();
+    stateIndex = animator::add(1000.0f / fps / speed);
     isLoaded = false;
-    looping = false;
 }
 
 Animation::~Animation() {
-    for (auto& keyframe : keyframes) glDeleteTextures(1, &keyframe);
+    animator::remove(stateIndex);
+
+    // shared sprites stay alive as long as another animation uses them
+    for (auto& keyframe : keyframes) textures::release(keyframe.texture);
 }
 
 void Animation::calculateFrameTime(int fps, float speed) {
-    frameTime = 1000.0f / fps / speed;
+    animator::getState(stateIndex).frameTime = 1000.0f / fps / speed;
 }
 
 void Animation::setKeyFrames(std::vector<unsigned int> newKeyframes) {
-    keyframes = newKeyframes;
-    isLoaded = true;
-}
+    std::vector<SpriteFrame> oldKeyframes = std::move(keyframes);
+    keyframes.clear();
+
+    // managed textures get a reference, others are owned by this animation from now on.
+    // new references are taken first, so a texture in both lists never drops to zero on the way
+    for (auto& keyframe : newKeyframes) {
+        textures::retain(keyframe);
+        keyframes.push_back({keyframe, 0.0f, 0.0f, 1.0f, 1.0f});
+    }
 
-void Animation::loadKeyFrames(std::vector<std::string> spriteNames, bool flip) {
-    for (auto& name : spriteNames) {
-        std::string path = engine::getSpritePath(name); // get sprite path from saved paths
+    for (auto& keyframe : oldKeyframes) {
+        // textures we own that are kept must not be deleted
+        bool owned = textures::getRefCount(keyframe.texture) == 0;
+        if (owned && std::find(newKeyframes.begin(), newKeyframes.end(), keyframe.texture) != newKeyframes.end()) continue;
 
-        unsigned int spriteID;
+        textures::release(keyframe.texture);
+    }
 
-        // generate texture id
-        glGenTextures(1, &spriteID);
-        glBindTexture(GL_TEXTURE_2D, spriteID);
+    syncFrameCount();
+    isLoaded = true;
+}
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void Animation::loadKeyFrames(std::vector<std::string> spriteNames, bool flip, bool asTextureArray) {
+    if (asTextureArray && !spriteNames.empty()) {
+        unsigned int arrayID = textures::acquireArray(spriteNames, flip);
 
-        // load image from file
-        Image loadedSprite = files::loadImage(path, flip);
+        if (arrayID != 0) {
+            // every keyframe holds its own reference, so they are all released the same way
+            for (unsigned int i = 0; i < spriteNames.size(); i++) {
+                if (i > 0) textures::retain(arrayID);
+                keyframes.push_back({arrayID, 0.0f, 0.0f, 1.0f, 1.0f, (float)i, true});
+            }
 
-        if (!loadedSprite.isLoaded) {
-            logError("Failed to load sprite: " + name, SPRITE_LOADING_ERROR);
-            isLoaded = false;
+            syncFrameCount();
+            isLoaded = true;
             return;
         }
+    }
 
-        // create texture from image
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, loadedSprite.width, loadedSprite.height, 0, 
-            loadedSprite.nrChannels == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, loadedSprite.data);
+    for (auto& name : spriteNames) {
+        // decoded and uploaded only once per sprite, atlas sprites only differ in uvs
+        SpriteFrame frame = textures::acquireFrame(name, flip);
 
-        if (!loadedSprite.data) {
-            logError("Failed to load sprite: " + name, SPRITE_LOADING_ERROR);
+        if (frame.texture == 0) {
+            syncFrameCount();
             isLoaded = false;
             return;
         }
 
-        // add texture id to keyframes
-        keyframes.push_back(spriteID);
-
-        // we don't need the image data anymore
-        loadedSprite.free();
+        keyframes.push_back(frame);
     }
 
+    syncFrameCount();
     isLoaded = true;
 }
 
@@ -77,46 +85,62 @@ void Animation::loadKeyFrames(std::vector<std::string> spriteNames, bool flip) {
 void Animation::step() {
     if (isLoaded == false) return;
     if (keyframes.size() == 0) return;
-    if (keyframes.size() == 1) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, keyframes[0]); // bind the only key frame
-        return;
-    }
 
-    double timeDiff = timer::getTimeDiff(animTimerID);
+    const SpriteFrame& frame = keyframes[animator::getState(stateIndex).frame];
 
-    // if the time difference is greater than the frame time, move to the next key frame
-    if (timeDiff >= frameTime) {
-        currentKeyframe++;
-        timer::resetTimer(animTimerID);
-    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(frame.isArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, frame.texture); // bind the current key frame
+}
 
-    // restart or stop the animation if it has reached the end
-    if (currentKeyframe >= keyframes.size()) {
-        if (looping) {
-            currentKeyframe = 0; // restart if looping
-        } else {
-            currentKeyframe = keyframes.size() - 1;
-            finished = true;
-        }
-    }
+void Animation::advance(double milliseconds) {
+    if (isLoaded == false) return;
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, keyframes[currentKeyframe]); // bind the current key frame
+    animator::advance(animator::getState(stateIndex), (float)milliseconds);
+}
+
+void Animation::markVisible() {
+    animator::markVisible(stateIndex);
+}
+
+void Animation::syncFrameCount() {
+    AnimationState& state = animator::getState(stateIndex);
+
+    state.frameCount = keyframes.size();
+    if (state.frame >= state.frameCount) state.frame = 0;
+}
+
+unsigned int Animation::getCurrentTexture() const {
+    if (!isLoaded || keyframes.empty()) return 0;
+
+    return keyframes[animator::getState(stateIndex).frame].texture;
+}
+
+SpriteFrame Animation::getCurrentFrame() const {
+    if (!isLoaded || keyframes.empty()) return {0, 0.0f, 0.0f, 1.0f, 1.0f};
+
+    return keyframes[animator::getState(stateIndex).frame];
+}
+
+bool Animation::isTextureArray() const {
+    return !keyframes.empty() && keyframes[0].isArray;
 }
 
 void Animation::deactivate() {
     glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 }
 
-void Animation::loop() { looping = true; }
-void Animation::stop() { looping = false; }
+void Animation::loop() { animator::getState(stateIndex).flags |= ANIMATION_LOOPING; }
+void Animation::stop() { animator::getState(stateIndex).flags &= ~ANIMATION_LOOPING; }
 
 void Animation::reset() {
-    currentKeyframe = 0;
-    finished = false;
+    AnimationState& state = animator::getState(stateIndex);
+
+    state.frame = 0;
+    state.accumulator = 0.0f;
+    state.flags &= ~ANIMATION_FINISHED;
 }
 
-bool Animation::isLooping() const { return looping; }
-bool Animation::isFinished() const { return finished; }
+bool Animation::isLooping() const { return animator::getState(stateIndex).flags & ANIMATION_LOOPING; }
+bool Animation::isFinished() const { return animator::getState(stateIndex).flags & ANIMATION_FINISHED; }
 bool Animation::isLoadedSuccessfully() const { return isLoaded; }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../sys/Textures.h"
+
 #include <vector>
 #include <string>
 
@@ -20,6 +22,9 @@ public:
      */
     ~Animation();
 
+    Animation(const Animation&) = delete;
+    Animation& operator=(const Animation&) = delete;
+
     /**
      * @brief Calculates the frame time based on the frames per second and speed.
      * Use this method to change speed or fps of animation.
@@ -30,6 +35,7 @@ public:
 
     /**
      * @brief Sets the keyframes of the animation.
+     * Textures from the texture manager get a new reference, other textures are deleted with the animation.
      * @param newKeyframes The vector of keyframe indices.
      */
     void setKeyFrames(std::vector<unsigned int> newKeyframes);
@@ -38,14 +44,46 @@ public:
      * @brief Loads the keyframes of the animation from sprite names.
      * @param spriteNames The vector of sprite names.
      * @param flip Indicates whether to flip the sprites horizontally.
+     * @param asTextureArray Loads all frames into one texture array, so objects on different frames can be drawn together.
+     * Frames must have the same size, otherwise they are loaded one by one.
      */
-    void loadKeyFrames(std::vector<std::string> spriteNames, bool flip = true);
+    void loadKeyFrames(std::vector<std::string> spriteNames, bool flip = true, bool asTextureArray = false);
 
     /**
-     * @brief Advances the animation by one frame.
+     * @brief Binds the texture of the current keyframe.
      */
     void step();
 
+    /**
+     * @brief Moves the animation forward by the given time, skipping keyframes if needed. Doesn't touch OpenGL state.
+     * Animations of visible objects are advanced by the engine, use this only to play an animation manually.
+     * @param milliseconds The time passed.
+     */
+    void advance(double milliseconds);
+
+    /**
+     * @brief Lets the engine advance the animation in this frame. Called for objects that are visible on screen.
+     */
+    void markVisible();
+
+    /**
+     * @brief Gets the texture of the current keyframe.
+     * @return The texture ID, or 0 if the animation has no keyframes.
+     */
+    unsigned int getCurrentTexture() const;
+
+    /**
+     * @brief Gets the texture and UV rectangle of the current keyframe.
+     * Frames packed into the same atlas page only differ in UVs, so switching them doesn't break batches.
+     * @return The frame, with texture 0 if the animation has no keyframes.
+     */
+    SpriteFrame getCurrentFrame() const;
+
+    /**
+     * @brief Checks if the keyframes are layers of one texture array.
+     */
+    bool isTextureArray() const;
+
     /**
      * @brief Deactivates the animation.
      */
@@ -85,16 +123,14 @@ public:
     bool isLoadedSuccessfully() const;
 
 private:
-    std::vector<unsigned int> keyframes; ///< The vector of keyframe indices.
+    /**
+     * @brief Copies the keyframe count into the playback state.
+     */
+    void syncFrameCount();
 
-    int currentKeyframe; ///< The index of the current keyframe.
-    double frameTime; ///< The time between frames.
+    std::vector<SpriteFrame> keyframes; ///< The textures and UV rectangles of the keyframes.
 
     bool isLoaded; ///< Indicates whether the animation has been loaded.
 
-    unsigned int animTimerID; ///< The ID of the animation timer.
-
-    bool looping; ///< Indicates whether the animation is looping.
-
-    bool finished; ///< Indicates whether the animation has finished.
+    unsigned int stateIndex; ///< The index of the playback state (current keyframe, timing, looping) in the animator.
 };
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @brief Branch free math helpers. Loops over arrays that only call these functions can be vectorized by the compiler.
+ */
+namespace fastmath {
+    constexpr float PI = 3.14159265358979f;
+    constexpr float TWO_PI = 6.28318530717959f;
+    constexpr float HALF_PI = 1.57079632679490f;
+    constexpr float DEG_TO_RAD = PI / 180.0f;
+
+    /**
+     * @brief Calculates sine and cosine together. Absolute error is below 1e-5 for angles within a few hundred radians.
+     *
+     * @param radians The angle in radians.
+     * @param outSin The sine of the angle.
+     * @param outCos The cosine of the angle.
+     */
+    inline void sinCos(float radians, float& outSin, float& outCos) {
+        // wrap into [-pi, pi], rounding with a truncating cast keeps it vectorizable
+        float turns = radians * (1.0f / TWO_PI);
+        float half = turns >= 0.0f ? 0.5f : -0.5f;
+        float x = radians - (float)(int)(turns + half) * TWO_PI;
+
+        // mirror into [-pi/2, pi/2], cosine changes sign on the mirrored half
+        float over = x > HALF_PI ? 1.0f : 0.0f;
+        float under = x < -HALF_PI ? 1.0f : 0.0f;
+
+        float mirrored = x + over * (PI - 2.0f * x) + under * (-PI - 2.0f * x);
+        float cosSign = 1.0f - 2.0f * (over + under);
+
+        float x2 = mirrored * mirrored;
+
+        outSin = mirrored * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f + x2 * (-1.0f / 39916800.0f))))));
+        outCos = cosSign * (1.0f + x2 * (-0.5f + x2 * (1.0f / 24.0f + x2 * (-1.0f / 720.0f + x2 * (1.0f / 40320.0f + x2 * (-1.0f / 3628800.0f + x2 * (1.0f / 479001600.0f)))))));
+    }
+
+    inline float sin(float radians) {
+        float s, c;
+        sinCos(radians, s, c);
+        return s;
+    }
+
+    inline float cos(float radians) {
+        float s, c;
+        sinCos(radians, s, c);
+        return c;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Q16.16 fixed point number. Every operation is integer math, so results are the same bit for bit
+ * on every machine and compiler. Range is about -32768 to 32767 with a step of 1/65536.
+ */
+struct Fixed {
+    int32_t raw;
+
+    static constexpr int FRACTION_BITS = 16;
+    static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+    static constexpr inline Fixed fromRaw(int32_t raw) { return {raw}; }
+    static constexpr inline Fixed fromInt(int32_t value) { return {value * ONE}; }
+
+    /**
+     * @brief Converts a float, rounding to the nearest step. Same float gives the same result everywhere.
+     * Values outside the range saturate to the largest or smallest number, NaN becomes 0.
+     */
+    static inline Fixed fromFloat(float value) {
+        double scaled = (double)value * ONE;
+        scaled = scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5;
+
+        // converting a double that doesn't fit into int32_t is undefined
+        if (!(scaled == scaled)) return {0};
+        if (scaled >= (double)INT32_MAX) return {INT32_MAX};
+        if (scaled <= (double)INT32_MIN) return {INT32_MIN};
+
+        return {(int32_t)scaled};
+    }
+
+    inline float toFloat() const { return (float)raw / ONE; }
+
+    inline Fixed operator+(Fixed other) const { return {raw + other.raw}; }
+    inline Fixed operator-(Fixed other) const { return {raw - other.raw}; }
+    inline Fixed operator-() const { return {-raw}; }
+
+    // 64 bit intermediates so nothing overflows before the shift, negative values round down
+    inline Fixed operator*(Fixed other) const { return {(int32_t)(((int64_t)raw * other.raw) >> FRACTION_BITS)}; }
+    inline Fixed operator/(Fixed other) const { return {(int32_t)(((int64_t)raw * ONE) / other.raw)}; }
+
+    inline Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+    inline Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+    inline Fixed& operator*=(Fixed other) { *this = *this * other; return *this; }
+
+    inline bool operator==(Fixed other) const { return raw == other.raw; }
+    inline bool operator!=(Fixed other) const { return raw != other.raw; }
+    inline bool operator<(Fixed other) const { return raw < other.raw; }
+    inline bool operator>(Fixed other) const { return raw > other.raw; }
+    inline bool operator<=(Fixed other) const { return raw <= other.raw; }
+    inline bool operator>=(Fixed other) const { return raw >= other.raw; }
+};
+
+/**
+ * @brief 2D vector of fixed point numbers.
+ */
+struct FixedVec2 {
+    Fixed x, y;
+
+    inline FixedVec2 operator+(const FixedVec2& other) const { return {x + other.x, y + other.y}; }
+    inline FixedVec2 operator-(const FixedVec2& other) const { return {x - other.x, y - other.y}; }
+    inline FixedVec2 operator*(Fixed scale) const { return {x * scale, y * scale}; }
+
+    inline FixedVec2& operator+=(const FixedVec2& other) { x += other.x; y += other.y; return *this; }
+    inline FixedVec2& operator-=(const FixedVec2& other) { x -= other.x; y -= other.y; return *this; }
+
+    inline Fixed dot(const FixedVec2& other) const { return x * other.x + y * other.y; }
+};
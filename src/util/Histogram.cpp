@@ -0,0 +1,99 @@
+#include "Histogram.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    inline unsigned long long toMicroseconds(double milliseconds) {
+        if (!(milliseconds > 0.0)) return 0;
+        return (unsigned long long)std::llround(milliseconds * 1000.0);
+    }
+}
+
+Histogram::Histogram() {
+    clear();
+}
+
+unsigned int Histogram::bucketOf(unsigned long long microseconds) {
+    // values below two sub bucket ranges are exact
+    if (microseconds < 2 * SUB_BUCKETS) return (unsigned int)microseconds;
+
+    unsigned int highestBit = 0;
+    while ((microseconds >> (highestBit + 1)) != 0) highestBit++;
+
+    if (highestBit >= MAX_BITS) return BUCKET_COUNT - 1;
+
+    // shift the value so its top SUB_BUCKET_BITS + 1 bits remain, the lower bits are the precision that is lost
+    unsigned int shift = highestBit - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (unsigned int)((microseconds >> shift) - SUB_BUCKETS);
+}
+
+double Histogram::getBucketValue(unsigned int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) return bucket * 0.001;
+
+    unsigned int shift = bucket / SUB_BUCKETS - 1;
+    unsigned long long subBucket = bucket % SUB_BUCKETS + SUB_BUCKETS;
+
+    return (double)(((subBucket + 1) << shift) - 1) * 0.001;
+}
+
+void Histogram::record(double milliseconds) {
+    unsigned long long microseconds = toMicroseconds(milliseconds);
+
+    counts[bucketOf(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+void Histogram::remove(double milliseconds) {
+    unsigned long long microseconds = toMicroseconds(milliseconds);
+
+    counts[bucketOf(microseconds)].fetch_sub(1, std::memory_order_relaxed);
+    total.fetch_sub(1, std::memory_order_relaxed);
+    sum.fetch_sub(microseconds, std::memory_order_relaxed);
+}
+
+void Histogram::clear() {
+    for (auto& count : counts) count.store(0, std::memory_order_relaxed);
+
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+}
+
+double Histogram::getPercentile(double percentile) const {
+    unsigned long long count = getCount();
+    if (count == 0) return 0.0;
+
+    // rank of the value, at least the first one
+    double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    unsigned long long rank = std::max(1ull, (unsigned long long)std::ceil(fraction * count));
+
+    unsigned long long seen = 0;
+    unsigned int last = 0;
+
+    for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+        unsigned long long bucketCount = counts[i].load(std::memory_order_relaxed);
+        if (bucketCount == 0) continue;
+
+        seen += bucketCount;
+        last = i;
+
+        if (seen >= rank) break;
+    }
+
+    return getBucketValue(last);
+}
+
+double Histogram::getAverage() const {
+    unsigned long long count = getCount();
+    if (count == 0) return 0.0;
+
+    return sum.load(std::memory_order_relaxed) * 0.001 / count;
+}
+
+unsigned long long Histogram::getCount() const { return total.load(std::memory_order_relaxed); }
+
+unsigned long long Histogram::getBucketCount(unsigned int bucket) const {
+    if (bucket >= BUCKET_COUNT) return 0;
+    return counts[bucket].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * @brief Histogram of durations with logarithmic buckets, like an HDR histogram. Every power of two is split
+ * into 32 linear buckets, so any value is kept within about 3% from 1 microsecond up to a minute.
+ * Memory is fixed and recording is a few atomic adds, so many threads can record at once without locks.
+ */
+class Histogram {
+public:
+    static constexpr unsigned int SUB_BUCKET_BITS = 5;
+    static constexpr unsigned int SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned int MAX_BITS = 26; // about 67 seconds in microseconds, longer values go to the last bucket
+    static constexpr unsigned int BUCKET_COUNT = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    Histogram();
+
+    /**
+     * @brief Adds a duration.
+     *
+     * @param milliseconds The duration in milliseconds.
+     */
+    void record(double milliseconds);
+
+    /**
+     * @brief Removes a duration that was recorded before. Used to slide a window over the last values.
+     */
+    void remove(double milliseconds);
+
+    void clear();
+
+    /**
+     * @brief Gets the value that the given percent of the durations are equal to or below.
+     *
+     * @param percentile Between 0 and 100.
+     * @return The duration in milliseconds, the upper end of its bucket. 0 if nothing is recorded.
+     */
+    double getPercentile(double percentile) const;
+
+    /**
+     * @brief Gets the average of the durations.
+     *
+     * @return The average in milliseconds, 0 if nothing is recorded.
+     */
+    double getAverage() const;
+
+    unsigned long long getCount() const;
+
+    /**
+     * @brief Gets how many durations fell into a bucket.
+     */
+    unsigned long long getBucketCount(unsigned int bucket) const;
+
+    /**
+     * @brief Gets the largest duration that falls into a bucket.
+     *
+     * @return The duration in milliseconds.
+     */
+    static double getBucketValue(unsigned int bucket);
+
+private:
+    static unsigned int bucketOf(unsigned long long microseconds);
+
+    std::atomic<unsigned long long> counts[BUCKET_COUNT];
+    std::atomic<unsigned long long> total;
+    std::atomic<unsigned long long> sum; // in microseconds
+};
@@ -6,12 +6,34 @@
 #include "../core/Application.h"
 
 #include "renderer/DefaultShaders.h"
+#include "FastMath.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cmath>
+#include <cstring>
+
+#define NOT_DIRTY 0xFFFFFFFF
+
+namespace {
+    std::vector<Object*> dirtyObjects;
+
+    // transform inputs and outputs laid out as arrays, so the update loop can be vectorized
+    std::vector<float> inX, inY, inWidth, inHeight, inAngle;
+    std::vector<float> outA, outB, outC, outD, outTX, outTY;
+
+    // T(center) * R(-angle) * S(width, height), the vectorized loop in updateDirtyTransforms does the same
+    Transform2D computeTransform(float x, float y, float width, float height, float angle) {
+        float s, c;
+        fastmath::sinCos(-angle * fastmath::DEG_TO_RAD, s, c);
+
+        return {width * c, width * s, -height * s, height * c, x + width / 2.0f, y + height / 2.0f};
+    }
+}
+
 Object::Object(ObjectType type, float x, float y, float width, float height, float angle) 
-            : type(type), x(x), y(y), width(width), height(height), angle(angle) {
+            : type(type), x(x), y(y), width(width), height(height), angle(angle), dirtyIndex(NOT_DIRTY) {
 
     createVertexData();
     createIndexData();
@@ -21,15 +43,29 @@ Object::Object(ObjectType type, float x, float y, float width, float height, flo
     animationClosed = false;
     visible = true;
     affectedByCamera = false;
+    collidable = type == ObjectType::ENTITY || type == ObjectType::SUB_ENTITY || type == ObjectType::HITBOX;
+    staticObject = false;
+    collisionLayer = 1;
+    collisionMask = 0xFFFFFFFF;
     isAnimationFlippedHorizontal = false;
     isAnimationFlippedVertical = false;
 
     setBuffers(engine::getBuffers(RECTANGULAR_BUFFERS));
     setShaders(defaultVertexShaderSource, defaultFragmentShaderSource);
+
+    markTransformDirty();
 }
 
 Object::~Object() {
     timer::killTimer(startTimerID);
+
+    // swap with the last dirty object so the list stays packed
+    if (dirtyIndex != NOT_DIRTY) {
+        Object* last = dirtyObjects.back();
+        dirtyObjects[dirtyIndex] = last;
+        last->dirtyIndex = dirtyIndex;
+        dirtyObjects.pop_back();
+    }
 }
 
 void Object::draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) {
@@ -59,7 +95,10 @@ void Object::draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera
 
         // pass data to vram and draw
         buffers.value()->bind();
-        buffers.value()->setVertexData(vertices, indices);
+
+        if (isAnimationStepUp) buffers.value()->setVertexData(mapTexCoords(animation.value()->getCurrentFrame()), indices);
+        else buffers.value()->setVertexData(vertices, indices);
+
         buffers.value()->drawElements(GL_TRIANGLES);
         buffers.value()->unbind();
     }
@@ -67,6 +106,54 @@ void Object::draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera
     if (isAnimationStepUp) { animation.value()->deactivate(); }
 }
 
+void Object::record(CommandBuffer& commands, const RenderContext& context) {
+    if (!visible) return;
+
+    // anything the batch shaders can't reproduce is drawn the old way
+    if (shaderKind == ShaderKind::CUSTOM || vertices.size() != 4 || indices.size() != 6) {
+        commands.pushCustom(this);
+        return;
+    }
+
+    if (!isInView(context)) return;
+
+    RenderCommand& command = commands.push(CommandType::QUAD);
+    command.affectedByCamera = affectedByCamera;
+
+    SpriteFrame frame = {0, 0.0f, 0.0f, 1.0f, 1.0f};
+
+    if (shaderKind == ShaderKind::TEXTURED && isAnimationValid() && !animationClosed) {
+        frame = animation.value()->getCurrentFrame();
+        command.texture = frame.texture;
+        command.textureArray = frame.isArray;
+    }
+
+    Transform2D world = getTransform();
+
+    // same order as createIndexData, so the batch can use a fixed quad index pattern
+    for (int i = 0; i < 4; i++) {
+        const Vertex& vertex = vertices[i];
+        float positionX = world.applyX(vertex.position.x, vertex.position.y);
+        float positionY = world.applyY(vertex.position.x, vertex.position.y);
+
+        // atlas frames only use a part of the texture
+        glm::vec2 texCoord(frame.u0 + vertex.texCoord.x * (frame.u1 - frame.u0), frame.v0 + vertex.texCoord.y * (frame.v1 - frame.v0));
+
+        command.vertices[i] = {glm::vec3(positionX, positionY, 1.0f), vertex.color, texCoord, frame.layer};
+    }
+}
+
+void Object::stepAnimation(const RenderContext& context) {
+    if (!visible || animationClosed || !isAnimationValid()) return;
+
+    // custom geometry may reach outside the bounds, so only batched quads are culled
+    if (shaderKind != ShaderKind::CUSTOM && !isInView(context)) return;
+
+    animation.value()->markVisible();
+}
+
+void Object::drawCustom(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) { draw(window, camera); }
+
 float Object::getX() const { return x; }
 float Object::getY() const { return y; }
 float Object::getWidth() const { return width; }
@@ -88,15 +175,17 @@ glm::vec4 Object::getColor(unsigned int vertexIndex) const {
     return vertices.at(vertexIndex).color;
 }
 
-void Object::setX(float x) { this->x = x; }
-void Object::setY(float y) { this->y = y; }
-void Object::setRotation(float angle) { this->angle = angle; }
-void Object::setWidth(float width) { this->width = width; }
-void Object::setHeight(float height) { this->height = height; }
+void Object::setX(float x) { this->x = x; markTransformDirty(); }
+void Object::setY(float y) { this->y = y; markTransformDirty(); }
+void Object::setRotation(float angle) { this->angle = angle; markTransformDirty(); }
+void Object::setWidth(float width) { this->width = width; markTransformDirty(); }
+void Object::setHeight(float height) { this->height = height; markTransformDirty(); }
 
 void Object::scale(float factor) {
     width *= factor;
     height *= factor;
+
+    markTransformDirty();
 }
 
 void Object::setColor(float r, float g, float b, float a, unsigned int vertexIndex) {
@@ -109,9 +198,25 @@ void Object::setAllColors(float r, float g, float b, float a) {
     }
 }
 
-void Object::loadAnimation(std::vector<std::string> paths, int fps, double speed, bool flip) {
+void Object::setAlpha(float a) {
+    for (auto& vertex : vertices) vertex.color.a = a;
+}
+
+void Object::setRed(float r) {
+    for (auto& vertex : vertices) vertex.color.r = r / 255.0f;
+}
+
+void Object::setGreen(float g) {
+    for (auto& vertex : vertices) vertex.color.g = g / 255.0f;
+}
+
+void Object::setBlue(float b) {
+    for (auto& vertex : vertices) vertex.color.b = b / 255.0f;
+}
+
+void Object::loadAnimation(std::vector<std::string> paths, int fps, double speed, bool flip, bool asTextureArray) {
     animation = std::make_unique<Animation>(fps, speed);
-    animation.value()->loadKeyFrames(paths, flip);
+    animation.value()->loadKeyFrames(paths, flip, asTextureArray);
 }
 
 void Object::createAnimation(std::vector<unsigned int> keyframes, int fps, double speed) {
@@ -123,7 +228,7 @@ void Object::setAnimation(std::shared_ptr<Animation> newAnimation) {
     animation.emplace(newAnimation);
 }
 
-bool Object::isAnimationValid() {
+bool Object::isAnimationValid() const {
     if (animation == nullptr) return false;
     if (!animation.has_value()) return false;
     if (animation.value()->isLoadedSuccessfully()) return true;
@@ -199,27 +304,156 @@ void Object::setBuffers(std::shared_ptr<Buffers> mBuffers) {
 
 void Object::setShaders(const char* vertexShaderSource, const char* fragmentShaderSource) {
     shaders = std::make_shared<Shaders>(vertexShaderSource, fragmentShaderSource);
+
+    bool defaultVertex = std::strcmp(vertexShaderSource, defaultVertexShaderSource) == 0 ||
+                         std::strcmp(vertexShaderSource, defaultCameraVertexShaderSource) == 0;
+
+    if (defaultVertex && std::strcmp(fragmentShaderSource, defaultFragmentShaderSource) == 0)
+        shaderKind = ShaderKind::TEXTURED;
+    else if (defaultVertex && std::strcmp(fragmentShaderSource, defaultNoTextureFragmentShaderSource) == 0)
+        shaderKind = ShaderKind::UNTEXTURED;
+    else
+        shaderKind = ShaderKind::CUSTOM;
 }
 
 glm::mat4 Object::getModelMatrix(int windowWidth, int windowHeight) const {
-    // Create Transformation Matrix
-    float scaleX = width / (windowWidth/2.0f);
-    float scaleY = height / (windowHeight/2.0f);
+    Transform2D world = getTransform();
 
     glm::mat4 model(1.0f);
-    model = glm::translate(model, glm::vec3(x + width/2.0f, y + height/2.0f, 1.0f));
-    model = glm::scale(model, glm::vec3(scaleX, scaleY, 1.0f));
-    model = glm::rotate(model, glm::radians(-angle), glm::vec3(0.0f, 0.0f, 1.0f));
+    model[0] = glm::vec4(world.a, world.b, 0.0f, 0.0f);
+    model[1] = glm::vec4(world.c, world.d, 0.0f, 0.0f);
+    model[3] = glm::vec4(world.tx, world.ty, 1.0f, 1.0f);
 
     return model;
 }
 
+AABB Object::getAABB() const {
+    Transform2D world = getTransform();
+
+    // half extents of the rotated unit quad
+    float extentX = (std::abs(world.a) + std::abs(world.c)) / 2.0f;
+    float extentY = (std::abs(world.b) + std::abs(world.d)) / 2.0f;
+
+    return {world.tx - extentX, world.ty - extentY, world.tx + extentX, world.ty + extentY};
+}
+
+void Object::setCollidable(bool collidable) { this->collidable = collidable; }
+bool Object::isCollidable() const { return collidable; }
+
+void Object::setStatic(bool isStatic) { staticObject = isStatic; }
+bool Object::isStatic() const { return staticObject; }
+
+void Object::setCollisionLayer(unsigned int layer) { collisionLayer = layer; }
+void Object::setCollisionMask(unsigned int mask) { collisionMask = mask; }
+unsigned int Object::getCollisionLayer() const { return collisionLayer; }
+unsigned int Object::getCollisionMask() const { return collisionMask; }
+
+Transform2D Object::getTransform() const {
+    // only happens when an object moves after the engine updated the transforms
+    if (dirtyIndex != NOT_DIRTY) return computeTransform(x, y, width, height, angle);
+
+    return transform;
+}
+
+void Object::markTransformDirty() {
+    if (dirtyIndex != NOT_DIRTY) return;
+
+    dirtyIndex = dirtyObjects.size();
+    dirtyObjects.push_back(this);
+}
+
+void Object::updateDirtyTransforms() {
+    size_t count = dirtyObjects.size();
+    if (count == 0) return;
+
+    inX.resize(count); inY.resize(count); inWidth.resize(count); inHeight.resize(count); inAngle.resize(count);
+    outA.resize(count); outB.resize(count); outC.resize(count); outD.resize(count); outTX.resize(count); outTY.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const Object* object = dirtyObjects[i];
+
+        inX[i] = object->x;
+        inY[i] = object->y;
+        inWidth[i] = object->width;
+        inHeight[i] = object->height;
+        inAngle[i] = object->angle;
+    }
+
+    const float* __restrict x = inX.data();
+    const float* __restrict y = inY.data();
+    const float* __restrict width = inWidth.data();
+    const float* __restrict height = inHeight.data();
+    const float* __restrict angle = inAngle.data();
+
+    float* __restrict a = outA.data();
+    float* __restrict b = outB.data();
+    float* __restrict c = outC.data();
+    float* __restrict d = outD.data();
+    float* __restrict tx = outTX.data();
+    float* __restrict ty = outTY.data();
+
+    // branch free, the compiler turns this into SIMD
+    for (size_t i = 0; i < count; i++) {
+        float sine, cosine;
+        fastmath::sinCos(-angle[i] * fastmath::DEG_TO_RAD, sine, cosine);
+
+        a[i] = width[i] * cosine;
+        b[i] = width[i] * sine;
+        c[i] = -height[i] * sine;
+        d[i] = height[i] * cosine;
+        tx[i] = x[i] + width[i] / 2.0f;
+        ty[i] = y[i] + height[i] / 2.0f;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        Object* object = dirtyObjects[i];
+
+        object->transform = {a[i], b[i], c[i], d[i], tx[i], ty[i]};
+        object->dirtyIndex = NOT_DIRTY;
+    }
+
+    dirtyObjects.clear();
+}
+
+bool Object::isInView(const RenderContext& context) const {
+    float radius = std::sqrt(width * width + height * height) / 2.0f;
+    float centerX = x + width / 2.0f;
+    float centerY = y + height / 2.0f;
+
+    float areaWidth = context.windowWidth;
+    float areaHeight = context.windowHeight;
+
+    if (affectedByCamera) {
+        centerX = centerX * context.cameraZoom + context.cameraX;
+        centerY = centerY * context.cameraZoom + context.cameraY;
+        radius *= std::abs(context.cameraZoom);
+
+        areaWidth = context.cameraWidth;
+        areaHeight = context.cameraHeight;
+    }
+
+    return centerX + radius >= 0 && centerX - radius <= areaWidth &&
+           centerY + radius >= 0 && centerY - radius <= areaHeight;
+}
+
+std::vector<Vertex> Object::mapTexCoords(const SpriteFrame& frame) const {
+    std::vector<Vertex> mapped = vertices;
+
+    for (auto& vertex : mapped) {
+        vertex.texCoord.x = frame.u0 + vertex.texCoord.x * (frame.u1 - frame.u0);
+        vertex.texCoord.y = frame.v0 + vertex.texCoord.y * (frame.v1 - frame.v0);
+    }
+
+    return mapped;
+}
+
 void Object::createVertexData() {
     // vertex position, color, texture coordinates
-    vertices.push_back({glm::vec3(-WINDOW_WIDTH/4.0f, -WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(1.0f, 1.0f)});
-    vertices.push_back({glm::vec3(WINDOW_WIDTH/4.0f, -WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(0.0f, 1.0f)});
-    vertices.push_back({glm::vec3(WINDOW_WIDTH/4.0f, WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(0.0f, 0.0f)});
-    vertices.push_back({glm::vec3(-WINDOW_WIDTH/4.0f, WINDOW_HEIGHT/4.0f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(1.0f, 0.0f)});
+    // unit quad, the transform stretches it to the object's size
+    vertices.push_back({glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(1.0f, 1.0f)});
+    vertices.push_back({glm::vec3(0.5f, -0.5f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(0.0f, 1.0f)});
+    vertices.push_back({glm::vec3(0.5f, 0.5f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(0.0f, 0.0f)});
+    vertices.push_back({glm::vec3(-0.5f, 0.5f, 0.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec2(1.0f, 0.0f)});
 }
 
 void Object::createIndexData() {
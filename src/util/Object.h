@@ -4,11 +4,14 @@
 
 #include "renderer/Shaders.h"
 #include "renderer/Buffers.h"
+#include "renderer/RenderCommands.h"
 
 #include "../classes/Camera.h"
 
 #include "Animation.h"
 #include "Window.h"
+#include "Transform2D.h"
+#include "AABB.h"
 
 #include <glm/glm.hpp>
 #include <map>
@@ -25,6 +28,12 @@ enum class ObjectType {
     OBJECT
 };
 
+enum class ShaderKind {
+    CUSTOM, // user shaders, drawn one by one with draw()
+    TEXTURED, // default shaders, batched
+    UNTEXTURED // default no texture shaders, batched
+};
+
 // TODO: add point system instead of using float
 
 /**
@@ -51,13 +60,41 @@ public:
     ~Object();
 
     /**
-     * @brief Draws the object on the screen. 
-     * Do not override this function unless you want to draw anything other than a rectangle.
+     * @brief Draws the object on the screen with its own buffers and shaders, without batching.
+     * It is final because objects are batched by record(), an override of it would never be called.
+     * To draw anything other than a rectangle, override record() to push a custom command and override drawCustom().
+     * 
+     * @param window The window to draw on.
+     * @param camera The camera to use for drawing.
+     */
+    virtual void draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera) final;
+
+    /**
+     * @brief Draws the object for a custom command on the GL thread. Calls draw() by default.
      * 
      * @param window The window to draw on.
      * @param camera The camera to use for drawing.
      */
-    virtual void draw(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera);
+    virtual void drawCustom(std::shared_ptr<Window> window, std::shared_ptr<Camera> camera);
+
+    /**
+     * @brief Records the commands to draw the object. Called by the engine from worker threads,
+     * so it must not change any shared state or call OpenGL.
+     * Objects with custom shaders or geometry record a command that calls drawCustom() on the GL thread.
+     * Override this function together with drawCustom() if the object should record something else.
+     * 
+     * @param commands The command buffer of the current thread.
+     * @param context The frame information.
+     */
+    virtual void record(CommandBuffer& commands, const RenderContext& context);
+
+    /**
+     * @brief Lets the animation advance in this frame if the object is visible, open and on screen.
+     * WARNING: This function is called automatically per frame by the engine.
+     * 
+     * @param context The frame information, used to skip objects out of view.
+     */
+    void stepAnimation(const RenderContext& context);
 
     /**
      * @brief Gets the x-coordinate of the object's position.
@@ -174,6 +211,22 @@ public:
      */
     void setAllColors(float r, float g, float b, float a = 1.0f);
 
+    /**
+     * @brief Sets the alpha of all vertices without changing their colors.
+     * 
+     * @param a The alpha component of the color (0.0 - 1.0).
+     */
+    void setAlpha(float a);
+
+    /**
+     * @brief Sets one color channel of all vertices without changing the others.
+     * 
+     * @param r The red component of the color (0.0 - 255.0).
+     */
+    void setRed(float r);
+    void setGreen(float g);
+    void setBlue(float b);
+
     /**
      * @brief Loads all sprites and creates the animation of the object.
      * 
@@ -181,8 +234,10 @@ public:
      * @param fps The frames per second of the animation.
      * @param speed The speed of the animation.
      * @param flip Whether to flip the animation frames horizontally.
+     * @param asTextureArray Whether to load all frames into one texture array. Frames must have the same size.
+     * Objects on different frames of such an animation are drawn in the same batch.
      */
-    void loadAnimation(std::vector<std::string> paths, int fps, double speed, bool flip);
+    void loadAnimation(std::vector<std::string> paths, int fps, double speed, bool flip, bool asTextureArray = false);
 
     /**
      * @brief Sets loaded key frames to the animation.
@@ -215,7 +270,7 @@ public:
      * 
      * @return True if the animation is valid, false otherwise.
      */
-    bool isAnimationValid();
+    bool isAnimationValid() const;
 
     /**
      * @brief Closes the animation of the object.
@@ -311,9 +366,78 @@ public:
      */
     unsigned int getID() const;
 
+    /**
+     * @brief Gets the axis aligned box around the rotated object.
+     * 
+     * @return The bounding box of the object.
+     */
+    AABB getAABB() const;
+
+    /**
+     * @brief Sets if the object takes part in collision queries.
+     * Entities, sub-entities and hitboxes are collidable by default, other objects are not.
+     * 
+     * @param collidable Whether the object is added to the broadphase.
+     */
+    void setCollidable(bool collidable);
+
+    /**
+     * @brief Checks if the object takes part in collision queries.
+     * 
+     * @return True if the object is collidable, false otherwise.
+     */
+    bool isCollidable() const;
+
+    /**
+     * @brief Marks the object as static geometry. Static objects are only tested against moving objects,
+     * never against each other. Objects are not static by default.
+     * 
+     * @param isStatic Whether the object is static.
+     */
+    void setStatic(bool isStatic);
+
+    /**
+     * @brief Checks if the object is static geometry.
+     * 
+     * @return True if the object is static, false otherwise.
+     */
+    bool isStatic() const;
+
+    /**
+     * @brief Sets the collision layers the object is on, as a bitfield. Layer 1 by default.
+     * Two objects are only tested for collision if each one's layer is in the other's mask.
+     * 
+     * @param layer The layer bits.
+     */
+    void setCollisionLayer(unsigned int layer);
+
+    /**
+     * @brief Sets the collision layers the object collides with, as a bitfield. All layers by default.
+     * 
+     * @param mask The mask bits.
+     */
+    void setCollisionMask(unsigned int mask);
+
+    unsigned int getCollisionLayer() const;
+    unsigned int getCollisionMask() const;
+
+    /**
+     * @brief Gets the cached transform of the object. Recomputed on the spot if the object moved since the last update.
+     * 
+     * @return The transform that maps the unit quad to the object's rectangle.
+     */
+    Transform2D getTransform() const;
+
+    /**
+     * @brief Recomputes the transforms of all objects that moved, rotated or resized since the last call in one pass.
+     * Objects that didn't change cost nothing.
+     * WARNING: This function is called automatically per frame by the engine.
+     */
+    static void updateDirtyTransforms();
+
 protected:
     /**
-     * @brief Gets the model matrix of the object.
+     * @brief Gets the model matrix of the object, built from the cached transform.
      * 
      * @param windowWidth The width of the window.
      * @param windowHeight The height of the window.
@@ -321,6 +445,27 @@ protected:
      */
     virtual glm::mat4 getModelMatrix(int windowWidth, int windowHeight) const;
 
+    /**
+     * @brief Checks if the bounding circle of the object overlaps the visible area.
+     * 
+     * @param context The frame information.
+     * @return True if the object may be visible.
+     */
+    bool isInView(const RenderContext& context) const;
+
+    /**
+     * @brief Marks the cached transform as outdated. Call after changing the position, size or angle directly.
+     */
+    void markTransformDirty();
+
+    /**
+     * @brief Copies the vertices with texture coordinates moved into the UV rectangle of a frame.
+     * 
+     * @param frame The frame of the animation.
+     * @return The vertices to upload.
+     */
+    std::vector<Vertex> mapTexCoords(const SpriteFrame& frame) const;
+
     /**
      * @brief Creates the vertex data of the object.
      */
@@ -355,8 +500,17 @@ private:
 
     bool visible; /**< Whether the object is visible or not. */
     bool affectedByCamera; /**< Whether the object is affected by the camera or not. */
+    bool collidable; /**< Whether the object is added to the broadphase or not. */
+    bool staticObject; /**< Whether the object is static geometry or not. */
+    unsigned int collisionLayer; /**< The layers the object is on. */
+    unsigned int collisionMask; /**< The layers the object collides with. */
 
     bool animationClosed; /**< Whether the animation of the object is closed or not. */
 
+    ShaderKind shaderKind; /**< Whether the shaders are the default ones that can be batched. */
+
+    Transform2D transform; /**< The cached transform, valid while the object is not in the dirty list. */
+    unsigned int dirtyIndex; /**< The position of the object in the dirty list. */
+
     ObjectType type; /**< The type of the object. */
 };
@@ -0,0 +1,124 @@
+#include "SpatialHash.h"
+
+#include <cmath>
+#include <algorithm>
+
+SpatialHash::SpatialHash(float cellSize) {
+    setCellSize(cellSize);
+}
+
+void SpatialHash::setCellSize(float cellSize) {
+    this->cellSize = cellSize > 0 ? cellSize : 64.0f;
+    inverseCellSize = 1.0f / this->cellSize;
+}
+
+float SpatialHash::getCellSize() const { return cellSize; }
+
+void SpatialHash::clear() {
+    boxes.clear();
+    ids.clear();
+    entries.clear();
+}
+
+int SpatialHash::toCell(float coordinate) const {
+    return (int)std::floor(coordinate * inverseCellSize);
+}
+
+unsigned long long SpatialHash::makeKey(int cellX, int cellY) {
+    return ((unsigned long long)(unsigned int)cellX << 32) | (unsigned int)cellY;
+}
+
+void SpatialHash::insert(unsigned int id, const AABB& box) {
+    unsigned int index = boxes.size();
+
+    boxes.push_back(box);
+    ids.push_back(id);
+
+    int minCellX = toCell(box.minX), maxCellX = toCell(box.maxX);
+    int minCellY = toCell(box.minY), maxCellY = toCell(box.maxY);
+
+    for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+            entries.push_back({makeKey(cellX, cellY), index});
+}
+
+void SpatialHash::build() {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cell < b.cell;
+    });
+}
+
+void SpatialHash::findPairs(std::vector<std::pair<unsigned int, unsigned int>>& pairs) const {
+    pairs.clear();
+
+    unsigned int begin = 0;
+
+    while (begin < entries.size()) {
+        unsigned long long cell = entries[begin].cell;
+
+        unsigned int end = begin + 1;
+        while (end < entries.size() && entries[end].cell == cell) end++;
+
+        for (unsigned int i = begin; i < end; i++) {
+            const AABB& a = boxes[entries[i].box];
+
+            for (unsigned int j = i + 1; j < end; j++) {
+                const AABB& b = boxes[entries[j].box];
+                if (!a.overlaps(b)) continue;
+
+                // only the first shared cell reports the pair
+                int firstX = std::max(toCell(a.minX), toCell(b.minX));
+                int firstY = std::max(toCell(a.minY), toCell(b.minY));
+                if (makeKey(firstX, firstY) != cell) continue;
+
+                unsigned int idA = ids[entries[i].box];
+                unsigned int idB = ids[entries[j].box];
+
+                pairs.push_back(idA < idB ? std::make_pair(idA, idB) : std::make_pair(idB, idA));
+            }
+        }
+
+        begin = end;
+    }
+}
+
+void SpatialHash::query(const AABB& area, std::vector<unsigned int>& result) const {
+    result.clear();
+
+    int minCellX = toCell(area.minX), maxCellX = toCell(area.maxX);
+    int minCellY = toCell(area.minY), maxCellY = toCell(area.maxY);
+
+    double cellCount = ((double)maxCellX - minCellX + 1) * ((double)maxCellY - minCellY + 1);
+
+    // large areas are cheaper to test box by box
+    if (cellCount > boxes.size()) {
+        for (unsigned int i = 0; i < boxes.size(); i++)
+            if (boxes[i].overlaps(area)) result.push_back(ids[i]);
+
+        return;
+    }
+
+    for (int cellX = minCellX; cellX <= maxCellX; cellX++) {
+        for (int cellY = minCellY; cellY <= maxCellY; cellY++) {
+            unsigned long long cell = makeKey(cellX, cellY);
+
+            auto first = std::lower_bound(entries.begin(), entries.end(), cell, [](const Entry& entry, unsigned long long key) {
+                return entry.cell < key;
+            });
+
+            for (auto it = first; it != entries.end() && it->cell == cell; ++it) {
+                const AABB& box = boxes[it->box];
+                if (!box.overlaps(area)) continue;
+
+                // a box in many cells is only reported by the first cell it shares with the area
+                int firstX = std::max(toCell(box.minX), minCellX);
+                int firstY = std::max(toCell(box.minY), minCellY);
+                if (firstX != cellX || firstY != cellY) continue;
+
+                result.push_back(ids[it->box]);
+            }
+        }
+    }
+}
+
+unsigned int SpatialHash::getBoxCount() const { return boxes.size(); }
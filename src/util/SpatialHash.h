@@ -0,0 +1,74 @@
+#pragma once
+
+#include "AABB.h"
+
+#include <vector>
+#include <utility>
+
+/**
+ * @brief Uniform grid broadphase. Boxes are inserted into every cell they touch, the cell entries are sorted
+ * by cell key, and boxes sharing a cell become candidate pairs. A pair is only reported by the first cell
+ * both boxes share, so the output has no duplicates without a lookup table.
+ * Queries don't change the hash, they can run on many threads at once.
+ */
+class SpatialHash {
+public:
+    /**
+     * @param cellSize Width and height of a cell. Works best around the size of a typical object.
+     */
+    SpatialHash(float cellSize = 64.0f);
+
+    void setCellSize(float cellSize);
+    float getCellSize() const;
+
+    /**
+     * @brief Removes all boxes.
+     */
+    void clear();
+
+    /**
+     * @brief Adds a box. Call build() after all boxes are added.
+     *
+     * @param id The value returned for this box by queries.
+     * @param box The bounds of the box.
+     */
+    void insert(unsigned int id, const AABB& box);
+
+    /**
+     * @brief Sorts the cell entries. Must be called before any query.
+     */
+    void build();
+
+    /**
+     * @brief Finds every pair of overlapping boxes.
+     *
+     * @param pairs Filled with (id, id) pairs, smaller id first.
+     */
+    void findPairs(std::vector<std::pair<unsigned int, unsigned int>>& pairs) const;
+
+    /**
+     * @brief Finds every box that overlaps an area.
+     *
+     * @param area The area to search.
+     * @param ids Filled with the ids of the boxes, each id once.
+     */
+    void query(const AABB& area, std::vector<unsigned int>& ids) const;
+
+    unsigned int getBoxCount() const;
+
+private:
+    struct Entry {
+        unsigned long long cell;
+        unsigned int box; // index into boxes
+    };
+
+    int toCell(float coordinate) const;
+    static unsigned long long makeKey(int cellX, int cellY);
+
+    std::vector<AABB> boxes;
+    std::vector<unsigned int> ids;
+    std::vector<Entry> entries; // sorted by cell after build
+
+    float cellSize;
+    float inverseCellSize;
+};
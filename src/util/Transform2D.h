@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FastMath.h"
+
+/**
+ * @brief 2D affine transform stored as a 3x2 matrix, columns are (a, b), (c, d) and (tx, ty).
+ * Maps a point of the unit quad (-0.5 to 0.5) to its place in the world.
+ */
+struct Transform2D {
+    float a, b;
+    float c, d;
+    float tx, ty;
+
+    inline float applyX(float px, float py) const { return a * px + c * py + tx; }
+    inline float applyY(float px, float py) const { return b * px + d * py + ty; }
+
+    /**
+     * @brief Builds translate * rotate * scale. Rotation goes the same way as Object angles.
+     *
+     * @param angle The rotation in degrees.
+     */
+    static inline Transform2D fromTRS(float x, float y, float angle, float scaleX, float scaleY) {
+        float s, c;
+        fastmath::sinCos(-angle * fastmath::DEG_TO_RAD, s, c);
+
+        return {scaleX * c, scaleX * s, -scaleY * s, scaleY * c, x, y};
+    }
+};
+
+/**
+ * @brief Combines two transforms, the right one is applied first.
+ */
+inline Transform2D operator*(const Transform2D& parent, const Transform2D& local) {
+    return {
+        parent.a * local.a + parent.c * local.b,
+        parent.b * local.a + parent.d * local.b,
+        parent.a * local.c + parent.c * local.d,
+        parent.b * local.c + parent.d * local.d,
+        parent.a * local.tx + parent.c * local.ty + parent.tx,
+        parent.b * local.tx + parent.d * local.ty + parent.ty
+    };
+}
@@ -12,8 +12,11 @@
 
 /* Implementation of Window class */
 
-Window::Window(const char* title, int width, int height) {
-    
+Window::Window(const char* title, int width, int height, bool headless) : _headless(headless) {
+
+    // Headless windows are never shown, frames go to an offscreen framebuffer instead
+    if (headless) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
     // Create an SDL window with the specified dimensions and title
     _GLFWWindow = glfwCreateWindow(width, height, title, NULL, NULL);
 
@@ -27,7 +30,10 @@ Window::Window(const char* title, int width, int height) {
 
     _projectionMatrix = glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, -1.0f, 1.0f);
 
-    if (!_GLFWWindow) return;
+    if (!_GLFWWindow) {
+        logError("Window could not be created", WINDOW_CREATION_ERROR);
+        return;
+    }
 
     glfwMakeContextCurrent(_GLFWWindow);
 
@@ -35,15 +41,34 @@ Window::Window(const char* title, int width, int height) {
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
         logError("OpenGL could not initialized correctly. ", OPENGL_INITIALIZATION_ERROR);
 
-    // Vsync
-    setVsync(1);
+    if (headless) {
+        // there is no screen to sync with
+        setVsync(0);
+
+        _frameBuffer = std::make_shared<FrameBuffer>(width, height);
+        _frameBuffer->bind();
+    } else {
+        // Vsync
+        setVsync(1);
+    }
+}
+
+Window::~Window() {
+    // the framebuffer needs the context of this window to delete its GL objects
+    _frameBuffer.reset();
+    glfwDestroyWindow(_GLFWWindow);
 }
 
-Window::~Window() { glfwDestroyWindow(_GLFWWindow); }
 void Window::hide() { glfwHideWindow(_GLFWWindow); }
 void Window::show() { glfwShowWindow(_GLFWWindow); }
 
 void Window::renderFrame() {
+    // nothing to present, just make sure the frame is submitted
+    if (_headless) {
+        glFlush();
+        return;
+    }
+
     glfwSwapBuffers(_GLFWWindow);
 }
 
@@ -51,6 +76,8 @@ void Window::clearFrame() {
     int width = getWidth();
     int height = getHeight();
 
+    if (_headless) _frameBuffer->bind();
+
     glViewport(0, 0, width, height);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -80,6 +107,8 @@ void Window::setBounds(int newWidth, int newHeight) {
     _width = newWidth;
     _height = newHeight;
 
+    if (_headless) _frameBuffer->resize(newWidth, newHeight);
+
     _projectionMatrix = glm::ortho(0.0f, static_cast<float>(newWidth), static_cast<float>(newHeight), 0.0f, -1.0f, 1.0f);
 }
 
@@ -91,6 +120,7 @@ void Window::setLocation(int x, int y) {
 }
 
 bool Window::isVsyncOn() { return _interval; }
+bool Window::isHeadless() { return _headless; }
 int Window::getX() { return _x; }
 int Window::getY() { return _y; }
 int Window::getWidth() { return _width; }
@@ -103,6 +133,8 @@ void Window::updateWindowBounds() {
     _width = width;
     _height = height;
 
+    if (_headless) _frameBuffer->resize(width, height);
+
     _projectionMatrix = glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, -1.0f, 1.0f);
 
     int x, y;
@@ -116,4 +148,5 @@ glm::mat4 Window::getProjectionMatrix() {
     return _projectionMatrix;
 }
 
+std::shared_ptr<FrameBuffer> Window::getFrameBuffer() { return _frameBuffer; }
 GLFWwindow* Window::getGLFWWindow() { return _GLFWWindow; }
@@ -4,8 +4,11 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include "renderer/FrameBuffer.h"
+
 #include <string>
 #include <vector>
+#include <memory>
 
 /**
  * @brief Class representing a window for graphics rendering.
@@ -15,8 +18,13 @@ class Window {
 public:
     /**
      * @brief Default constructor
+     *
+     * @param title The title of the window.
+     * @param width The width of the window.
+     * @param height The height of the window.
+     * @param headless Creates an invisible window and renders into an offscreen framebuffer instead of the screen.
      */
-    Window(const char* title, int width, int height);
+    Window(const char* title, int width, int height, bool headless = false);
 
     /**
      * @brief Destroy the Window object
@@ -81,6 +89,18 @@ public:
      */
     bool isVsyncOn();
 
+    /**
+     * @brief Checks if the window renders into an offscreen framebuffer.
+     */
+    bool isHeadless();
+
+    /**
+     * @brief Gets the offscreen render target of a headless window.
+     *
+     * @return The framebuffer, or nullptr if the window is not headless.
+     */
+    std::shared_ptr<FrameBuffer> getFrameBuffer();
+
     /**
      * @brief Gets the X coordinate of the window.
      * 
@@ -123,6 +143,8 @@ public:
 private:
     GLFWwindow* _GLFWWindow; /**< Pointer to the GLFW window. */
 
+    std::shared_ptr<FrameBuffer> _frameBuffer; /**< Offscreen render target, only created for headless windows. */
+
     glm::mat4 _projectionMatrix;
 
     int _width;
@@ -132,5 +154,6 @@ private:
 
     bool _interval;
     bool _fullscreen;
+    bool _headless;
 };
  
\ No newline at end of file
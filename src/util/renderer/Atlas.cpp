@@ -0,0 +1,192 @@
+#include "Atlas.h"
+
+#include <algorithm>
+
+#include <glad/glad.h>
+
+/* SkylinePacker */
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height), usedArea(0) {
+    skyline.push_back({0, 0, width});
+}
+
+int SkylinePacker::fitHeight(unsigned int segmentIndex, int rectWidth, int rectHeight) const {
+    int x = skyline[segmentIndex].x;
+    if (x + rectWidth > width) return -1;
+
+    int top = 0;
+    int remaining = rectWidth;
+
+    // the rectangle rests on the highest segment below it
+    for (unsigned int i = segmentIndex; remaining > 0; i++) {
+        top = std::max(top, skyline[i].y);
+        if (top + rectHeight > height) return -1;
+
+        remaining -= skyline[i].width;
+    }
+
+    return top;
+}
+
+bool SkylinePacker::insert(int rectWidth, int rectHeight, int& outX, int& outY) {
+    int bestIndex = -1;
+    int bestTop = height;
+    int bestWidth = width;
+
+    for (unsigned int i = 0; i < skyline.size(); i++) {
+        int top = fitHeight(i, rectWidth, rectHeight);
+        if (top < 0) continue;
+
+        // lowest top edge first, narrowest segment breaks ties
+        if (top + rectHeight < bestTop || (top + rectHeight == bestTop && skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top + rectHeight;
+            bestWidth = skyline[i].width;
+        }
+    }
+
+    if (bestIndex < 0) return false;
+
+    outX = skyline[bestIndex].x;
+    outY = bestTop - rectHeight;
+
+    skyline.insert(skyline.begin() + bestIndex, {outX, bestTop, rectWidth});
+
+    // cut the segments now covered by the new one
+    for (unsigned int i = bestIndex + 1; i < skyline.size(); i++) {
+        int coveredEnd = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= coveredEnd) break;
+
+        int shrink = coveredEnd - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+
+        if (skyline[i].width > 0) break;
+
+        skyline.erase(skyline.begin() + i);
+        i--;
+    }
+
+    // merge neighbours at the same height
+    for (unsigned int i = 0; i + 1 < skyline.size(); i++) {
+        if (skyline[i].y != skyline[i + 1].y) continue;
+
+        skyline[i].width += skyline[i + 1].width;
+        skyline.erase(skyline.begin() + i + 1);
+        i--;
+    }
+
+    usedArea += (long long)rectWidth * rectHeight;
+
+    return true;
+}
+
+float SkylinePacker::getOccupancy() const {
+    return (float)usedArea / ((float)width * height);
+}
+
+/* Atlas */
+
+Atlas::Atlas(int pageSize, int padding) : pageSize(pageSize), padding(padding) {}
+
+bool Atlas::add(const std::string& name, const Image& image) {
+    if (!image.isLoaded || !image.data) return false;
+
+    int paddedWidth = image.width + padding * 2;
+    int paddedHeight = image.height + padding * 2;
+
+    if (paddedWidth > pageSize || paddedHeight > pageSize) return false;
+
+    int x, y;
+    unsigned int pageIndex = 0;
+
+    while (true) {
+        if (pageIndex == pages.size())
+            pages.push_back({SkylinePacker(pageSize, pageSize), std::vector<unsigned char>((size_t)pageSize * pageSize * 4, 0)});
+
+        if (pages[pageIndex].packer.insert(paddedWidth, paddedHeight, x, y)) break;
+
+        pageIndex++;
+    }
+
+    copyImage(pages[pageIndex], image, x, y);
+
+    AtlasRegion region;
+    region.page = pageIndex;
+    region.x = x + padding;
+    region.y = y + padding;
+    region.width = image.width;
+    region.height = image.height;
+    region.u0 = (float)region.x / pageSize;
+    region.v0 = (float)region.y / pageSize;
+    region.u1 = (float)(region.x + region.width) / pageSize;
+    region.v1 = (float)(region.y + region.height) / pageSize;
+
+    regions[name] = region;
+
+    return true;
+}
+
+void Atlas::copyImage(Page& page, const Image& image, int x, int y) {
+    int paddedWidth = image.width + padding * 2;
+    int paddedHeight = image.height + padding * 2;
+
+    for (int row = 0; row < paddedHeight; row++) {
+        // border pixels repeat the nearest edge of the image
+        int sourceRow = std::clamp(row - padding, 0, image.height - 1);
+
+        for (int column = 0; column < paddedWidth; column++) {
+            int sourceColumn = std::clamp(column - padding, 0, image.width - 1);
+
+            const unsigned char* source = image.data + ((size_t)sourceRow * image.width + sourceColumn) * image.nrChannels;
+            unsigned char* target = page.pixels.data() + ((size_t)(y + row) * pageSize + x + column) * 4;
+
+            switch (image.nrChannels) {
+                case 1: target[0] = target[1] = target[2] = source[0]; target[3] = 255; break;
+                case 2: target[0] = target[1] = target[2] = source[0]; target[3] = source[1]; break;
+                case 3: target[0] = source[0]; target[1] = source[1]; target[2] = source[2]; target[3] = 255; break;
+                default: target[0] = source[0]; target[1] = source[1]; target[2] = source[2]; target[3] = source[3]; break;
+            }
+        }
+    }
+}
+
+std::vector<unsigned int> Atlas::upload() {
+    std::vector<unsigned int> textureIDs;
+
+    for (auto& page : pages) {
+        unsigned int textureID;
+
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pageSize, pageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, page.pixels.data());
+
+        textureIDs.push_back(textureID);
+
+        // pixels live on the gpu from now on
+        std::vector<unsigned char>().swap(page.pixels);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (auto& [name, region] : regions) region.page = textureIDs[region.page];
+
+    return textureIDs;
+}
+
+bool Atlas::getRegion(const std::string& name, AtlasRegion& region) const {
+    auto found = regions.find(name);
+    if (found == regions.end()) return false;
+
+    region = found->second;
+    return true;
+}
+
+const std::map<std::string, AtlasRegion>& Atlas::getRegions() const { return regions; }
+unsigned int Atlas::getPageCount() const { return pages.size(); }
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../../sys/Files.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * @brief Place of an image inside an atlas page. UVs cover only the image, not its padding.
+ */
+struct AtlasRegion {
+    unsigned int page; /**< index of the page, or the texture ID after the atlas is uploaded. */
+    int x, y, width, height; /**< pixels of the image inside the page. */
+    float u0, v0, u1, v1;
+};
+
+/**
+ * @brief Skyline bottom left rectangle packer. Keeps the top edge of the packed area as a list of segments
+ * and puts each rectangle where it ends up lowest.
+ */
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height);
+
+    /**
+     * @brief Finds a place for a rectangle and marks it as used.
+     *
+     * @return False if the rectangle doesn't fit anymore.
+     */
+    bool insert(int width, int height, int& outX, int& outY);
+
+    /**
+     * @brief Gets the used area divided by the total area.
+     */
+    float getOccupancy() const;
+
+private:
+    struct Segment {
+        int x, y, width;
+    };
+
+    // top of the rectangles under [x, x + width) if it fits there, -1 otherwise
+    int fitHeight(unsigned int segmentIndex, int width, int height) const;
+
+    std::vector<Segment> skyline;
+
+    int width, height;
+    long long usedArea;
+};
+
+/**
+ * @brief Packs images into a few large RGBA pages so objects using different sprites can share one texture.
+ * Each image is surrounded by a border that repeats its edge pixels, so filtering never reads a neighbour.
+ */
+class Atlas {
+public:
+    /**
+     * @param pageSize Width and height of a page in pixels.
+     * @param padding Border around each image in pixels.
+     */
+    Atlas(int pageSize = 2048, int padding = 2);
+
+    /**
+     * @brief Copies an image into the first page it fits, a new page is opened when none has room.
+     *
+     * @param name The name the region is saved with.
+     * @param image The loaded image, 1 to 4 channels.
+     * @return False if the image is larger than a page.
+     */
+    bool add(const std::string& name, const Image& image);
+
+    /**
+     * @brief Creates one texture per page and frees the pixels. Region pages become texture IDs.
+     *
+     * @return The texture IDs of the pages.
+     */
+    std::vector<unsigned int> upload();
+
+    /**
+     * @brief Gets where an image was placed.
+     *
+     * @return False if no image was added with this name.
+     */
+    bool getRegion(const std::string& name, AtlasRegion& region) const;
+
+    const std::map<std::string, AtlasRegion>& getRegions() const;
+
+    unsigned int getPageCount() const;
+
+private:
+    struct Page {
+        SkylinePacker packer;
+        std::vector<unsigned char> pixels;
+    };
+
+    void copyImage(Page& page, const Image& image, int x, int y);
+
+    std::vector<Page> pages;
+    std::map<std::string, AtlasRegion> regions;
+
+    int pageSize;
+    int padding;
+};
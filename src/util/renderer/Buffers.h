@@ -9,6 +9,7 @@ struct Vertex {
     glm::vec3 position;
     glm::vec4 color;
     glm::vec2 texCoord;
+    float layer; // texture array layer, only read by the array shaders
 };
 
 class Buffers {
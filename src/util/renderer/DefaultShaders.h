@@ -71,6 +71,72 @@ void main() {
 }
     )";
 
+    // texture array variants, used by the batch renderer for animations loaded into one array
+    const char* defaultArrayVertexShaderSource = R"(
+#version 330 core
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+layout (location = 2) in vec2 a_TexCoord;
+layout (location = 3) in float a_Layer;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+out float v_Layer;
+
+uniform mat4 u_Model;
+uniform mat4 u_View;
+
+void main() {
+    gl_Position = u_View * u_Model * vec4(a_Position, 1.0);
+
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_Layer = a_Layer;
+}
+    )";
+
+    const char* defaultArrayCameraVertexShaderSource = R"(
+#version 330 core
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+layout (location = 2) in vec2 a_TexCoord;
+layout (location = 3) in float a_Layer;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+out float v_Layer;
+
+uniform mat4 u_Model;
+uniform mat4 u_View;
+uniform mat4 u_Projection;
+
+void main() {
+    gl_Position = u_Projection * u_View * u_Model * vec4(a_Position, 1.0);
+
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_Layer = a_Layer;
+}
+    )";
+
+    const char* defaultArrayFragmentShaderSource = R"(
+#version 330 core
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+in float v_Layer;
+
+out vec4 FragColor;
+
+uniform sampler2DArray u_Texture;
+
+void main() {
+    FragColor = texture(u_Texture, vec3(v_TexCoord, v_Layer)) * v_Color;
+}
+    )";
+
     const char* defaultTextVertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
@@ -0,0 +1,69 @@
+#include "FrameBuffer.h"
+
+#include "../../sys/Logger.h"
+
+#include <glad/glad.h>
+
+FrameBuffer::FrameBuffer(int width, int height) : width(width), height(height) {
+    glGenFramebuffers(1, &m_fbo);
+    glGenRenderbuffers(1, &m_colorRbo);
+    glGenRenderbuffers(1, &m_depthRbo);
+
+    allocateAttachments();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRbo);
+
+    if (!isComplete())
+        logError("Offscreen framebuffer is incomplete", FRAMEBUFFER_INCOMPLETE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+FrameBuffer::~FrameBuffer() {
+    glDeleteFramebuffers(1, &m_fbo);
+    glDeleteRenderbuffers(1, &m_colorRbo);
+    glDeleteRenderbuffers(1, &m_depthRbo);
+}
+
+void FrameBuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+}
+
+void FrameBuffer::unbind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height) return;
+
+    width = newWidth;
+    height = newHeight;
+
+    allocateAttachments();
+}
+
+bool FrameBuffer::isComplete() const {
+    GLint bound = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &bound);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, bound);
+
+    return complete;
+}
+
+int FrameBuffer::getWidth() const { return width; }
+int FrameBuffer::getHeight() const { return height; }
+
+void FrameBuffer::allocateAttachments() {
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @brief Offscreen render target made of a color and a depth-stencil renderbuffer.
+ * Used as the back buffer of headless windows, so frames can be rendered and read back without a display.
+ */
+class FrameBuffer {
+public:
+    /**
+     * @brief Creates the framebuffer and allocates its attachments.
+     *
+     * @param width The width of the render target in pixels.
+     * @param height The height of the render target in pixels.
+     */
+    FrameBuffer(int width, int height);
+
+    /**
+     * @brief Deletes the framebuffer and its attachments.
+     */
+    ~FrameBuffer();
+
+    /**
+     * @brief Binds the framebuffer for both drawing and reading.
+     */
+    void bind() const;
+
+    /**
+     * @brief Binds the default framebuffer back.
+     */
+    void unbind() const;
+
+    /**
+     * @brief Reallocates the attachments with a new size.
+     *
+     * @param newWidth The new width in pixels.
+     * @param newHeight The new height in pixels.
+     */
+    void resize(int newWidth, int newHeight);
+
+    /**
+     * @brief Checks if the framebuffer is complete and can be rendered into.
+     */
+    bool isComplete() const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    /**
+     * @brief Allocates storage of the attachments with the current size.
+     */
+    void allocateAttachments();
+
+    unsigned int m_fbo;
+    unsigned int m_colorRbo;
+    unsigned int m_depthRbo;
+
+    int width;
+    int height;
+};
@@ -0,0 +1,33 @@
+#include "RenderCommands.h"
+
+CommandBuffer::CommandBuffer() : currentKey(0) {}
+
+void CommandBuffer::beginObject(unsigned int order) {
+    currentKey = (unsigned long long)order << 32;
+}
+
+RenderCommand& CommandBuffer::push(CommandType type) {
+    commands.emplace_back();
+
+    RenderCommand& command = commands.back();
+    command.sortKey = currentKey++;
+    command.type = type;
+    command.affectedByCamera = false;
+    command.texture = 0;
+    command.textureArray = false;
+    command.object = nullptr;
+
+    return command;
+}
+
+void CommandBuffer::pushCustom(Object* object) {
+    push(CommandType::CUSTOM).object = object;
+}
+
+void CommandBuffer::clear() {
+    commands.clear();
+}
+
+const std::vector<RenderCommand>& CommandBuffer::getCommands() const {
+    return commands;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Buffers.h"
+
+#include <vector>
+
+class Object;
+
+enum class CommandType : unsigned char {
+    QUAD, // textured or colored rectangle, drawn in batches
+    OUTLINE, // rectangle outline, drawn by the debug line renderer
+    CUSTOM // object with its own shaders or geometry, its drawCustom function is called on the GL thread
+};
+
+/**
+ * @brief One recorded draw. Vertices are already transformed, so replaying a command needs no matrix math.
+ */
+struct RenderCommand {
+    unsigned long long sortKey; /**< painter order, commands are replayed from the lowest key. */
+    CommandType type;
+    bool affectedByCamera;
+    unsigned int texture; /**< 0 for untextured quads. */
+    bool textureArray; /**< texture is a texture array, vertices carry the layer. */
+    Object* object; /**< only set for CUSTOM commands. */
+    Vertex vertices[4];
+};
+
+/**
+ * @brief Everything a record function needs to know about the frame. Read only while recording.
+ */
+struct RenderContext {
+    int windowWidth;
+    int windowHeight;
+
+    float cameraX, cameraY;
+    float cameraZoom;
+    float cameraWidth, cameraHeight;
+
+    bool showHitboxes;
+};
+
+/**
+ * @brief Commands recorded by one thread. Each recording thread owns one buffer, so pushing needs no locks.
+ */
+class CommandBuffer {
+public:
+    CommandBuffer();
+
+    /**
+     * @brief Sets the painter order of the object being recorded.
+     * Commands pushed after this call are sorted by this order, then by the order they were pushed.
+     *
+     * @param order Position of the object in the rendering queue.
+     */
+    void beginObject(unsigned int order);
+
+    /**
+     * @brief Adds a command with the next sort key and returns it for filling.
+     */
+    RenderCommand& push(CommandType type);
+
+    /**
+     * @brief Adds a command that calls object->drawCustom on the GL thread.
+     */
+    void pushCustom(Object* object);
+
+    void clear();
+
+    const std::vector<RenderCommand>& getCommands() const;
+
+private:
+    std::vector<RenderCommand> commands;
+
+    unsigned long long currentKey;
+};